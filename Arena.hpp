@@ -0,0 +1,198 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+// Bump allocator for population storage.
+// Memory comes in blocks that are aligned to (and a multiple of) a 2 MiB huge page, and on
+// Linux the kernel is asked to back them with transparent huge pages. Every allocation
+// starts on a cache line, so two individuals' hot data never share one.
+// Nothing is freed individually: Reset() rewinds the arena so the next trial reuses the
+// same blocks. It is also a std::pmr::memory_resource, so chromosomes that own a
+// variable-length buffer (SpecChromosome) can keep that buffer in the arena too.
+class Arena : public std::pmr::memory_resource
+{
+public:
+    static constexpr std::size_t CACHE_LINE_SIZE = 64;
+    static constexpr std::size_t HUGE_PAGE_SIZE = std::size_t{2} << 20;
+
+    Arena() = default;
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    ~Arena() override
+    {
+        for (Block& block : blocks_)
+            std::free(block.data);
+    }
+
+    // Rewinds to the start, keeping the blocks for reuse.
+    // If the last round spilled over into several blocks, they are merged into one block
+    // big enough for all of it, so a repeated workload settles into a single block.
+    void Reset()
+    {
+        if (blocks_.size() > 1)
+        {
+            std::size_t total = 0;
+            for (Block& block : blocks_)
+            {
+                total += block.size;
+                std::free(block.data);
+            }
+            blocks_.clear();
+            AddBlock(total);
+        }
+
+        current_ = 0;
+        offset_ = 0;
+        used_ = 0;
+    }
+
+    std::size_t BytesUsed() const { return used_; }
+    std::size_t PeakBytesUsed() const { return peak_; }
+    std::size_t BlockCount() const { return blocks_.size(); }
+
+    std::size_t BytesReserved() const
+    {
+        std::size_t total = 0;
+        for (const Block& block : blocks_)
+            total += block.size;
+        return total;
+    }
+
+private:
+    struct Block
+    {
+        std::byte* data;
+        std::size_t size;
+    };
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        alignment = std::max(alignment, CACHE_LINE_SIZE);
+
+        // try the current block, then any blocks left over from an earlier round
+        for (; current_ < blocks_.size(); current_++, offset_ = 0)
+        {
+            const std::size_t start = (offset_ + alignment - 1) & ~(alignment - 1);
+            if (start + bytes <= blocks_[current_].size)
+            {
+                offset_ = start + bytes;
+                used_ += bytes;
+                peak_ = std::max(peak_, used_);
+                return blocks_[current_].data + start;
+            }
+        }
+
+        AddBlock(bytes);
+        offset_ = bytes;
+        used_ += bytes;
+        peak_ = std::max(peak_, used_);
+        return blocks_[current_].data;
+    }
+
+    // individual allocations are only released by Reset()
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    void AddBlock(std::size_t minimumSize)
+    {
+        const std::size_t size =
+            std::max(HUGE_PAGE_SIZE, (minimumSize + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1));
+        void* data = std::aligned_alloc(HUGE_PAGE_SIZE, size);
+        if (data == nullptr) throw std::bad_alloc();
+#ifdef __linux__
+        madvise(data, size, MADV_HUGEPAGE);  // only a hint, failure is harmless
+#endif
+        blocks_.push_back(Block{static_cast<std::byte*>(data), size});
+        current_ = blocks_.size() - 1;
+    }
+
+    std::vector<Block> blocks_;
+    std::size_t current_ = 0;  // block that allocations are currently taken from
+    std::size_t offset_ = 0;   // first free byte of the current block
+    std::size_t used_ = 0;
+    std::size_t peak_ = 0;
+};
+
+// Arena shared by every GA run on the calling thread.
+// Each run rewinds it when it starts, so only one run per thread may be active at a time.
+inline Arena& ThreadArena()
+{
+    thread_local Arena arena;
+    return arena;
+}
+
+// Fixed-size array of Ts in an arena. The elements are destroyed with the array,
+// the memory goes back when the arena is reset.
+template <typename T>
+class ArenaArray
+{
+public:
+    ArenaArray() = default;
+
+    // Every element is initialized from make(), which lets elements that hold an allocator
+    // be constructed with one that points into the arena.
+    template <typename Factory>
+    ArenaArray(Arena& arena, std::size_t count, Factory make)
+        : data_(static_cast<T*>(arena.allocate(count * sizeof(T), alignof(T)))), size_(count)
+    {
+        for (std::size_t i = 0; i < count; i++)
+            ::new (static_cast<void*>(data_ + i)) T(make());
+    }
+
+    ArenaArray(const ArenaArray&) = delete;
+    ArenaArray& operator=(const ArenaArray&) = delete;
+
+    ArenaArray(ArenaArray&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0))
+    {
+    }
+
+    ArenaArray& operator=(ArenaArray&& other) noexcept
+    {
+        ArenaArray(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    ~ArenaArray() { std::destroy_n(data_, size_); }
+
+    void swap(ArenaArray& other) noexcept
+    {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+    }
+
+    T& operator[](std::size_t i) { return data_[i]; }
+    const T& operator[](std::size_t i) const { return data_[i]; }
+
+    std::size_t size() const { return size_; }
+    T* begin() { return data_; }
+    T* end() { return data_ + size_; }
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+
+private:
+    T* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+template <typename T>
+void swap(ArenaArray<T>& a, ArenaArray<T>& b) noexcept
+{
+    a.swap(b);
+}
@@ -0,0 +1,470 @@
+#include "Daemon.hpp"
+
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <condition_variable>
+#include <csignal>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+// Just enough JSON for a flat job object: string, number, literal and string array values.
+class JobParser
+{
+public:
+    explicit JobParser(std::string_view text)
+        : text_(text)
+    {
+    }
+
+    bool Parse(DaemonJob& job, std::string& error)
+    {
+        if (!Expect('{')) return Fail(error, "a job must be a JSON object");
+        if (Peek() == '}') return Finish(error);
+
+        do
+        {
+            std::string key;
+            if (!ParseString(key) || !Expect(':')) return Fail(error, "malformed object key");
+
+            if (key == "id")
+            {
+                // kept as JSON, it is only ever echoed back
+                SkipSpace();
+                const std::size_t start = pos_;
+                std::string token;
+                if (!(Peek() == '"' ? ParseString(token) : ParseIdToken(token)))
+                    return Fail(error, "malformed id");
+                job.id = std::string(text_.substr(start, pos_ - start));
+            }
+            else if (key == "args" || key == "rooms")
+            {
+                std::vector<std::string>& values = key == "args" ? job.args : job.rooms;
+                if (!ParseStringArray(values))
+                    return Fail(error, key + " must be an array of strings");
+            }
+            else if (key == "seed")
+            {
+                std::string token;
+                uint64_t seed = 0;
+                if (!ParseToken(token)) return Fail(error, "malformed seed");
+                const auto [end, ec] =
+                    std::from_chars(token.data(), token.data() + token.size(), seed);
+                if (ec != std::errc() || end != token.data() + token.size())
+                    return Fail(error, "seed must be an unsigned 64-bit integer");
+                job.seed = seed;
+            }
+            else
+                return Fail(error, "unknown job field " + key);
+        } while (Expect(','));
+
+        if (!Expect('}')) return Fail(error, "expected , or } in the job object");
+        return Finish(error);
+    }
+
+private:
+    bool Finish(std::string& error)
+    {
+        SkipSpace();
+        return pos_ == text_.size() || Fail(error, "trailing text after the job object");
+    }
+
+    static bool Fail(std::string& error, std::string message)
+    {
+        error = std::move(message);
+        return false;
+    }
+
+    void SkipSpace()
+    {
+        while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_])))
+            pos_++;
+    }
+
+    char Peek()
+    {
+        SkipSpace();
+        return pos_ < text_.size() ? text_[pos_] : '\0';
+    }
+
+    bool Expect(char c)
+    {
+        if (Peek() != c) return false;
+        pos_++;
+        return true;
+    }
+
+    // a number or true/false/null, as written
+    bool ParseToken(std::string& token)
+    {
+        SkipSpace();
+        const std::size_t start = pos_;
+        while (pos_ < text_.size() && (std::isalnum(static_cast<unsigned char>(text_[pos_])) ||
+                                       text_[pos_] == '-' || text_[pos_] == '+' ||
+                                       text_[pos_] == '.'))
+            pos_++;
+        token = text_.substr(start, pos_ - start);
+        return !token.empty();
+    }
+
+    // a token the id may be echoed back as: true, false, null or a finite number
+    bool ParseIdToken(std::string& token)
+    {
+        if (!ParseToken(token)) return false;
+        if (token == "true" || token == "false" || token == "null") return true;
+
+        double number = 0.0;
+        const auto [end, ec] = std::from_chars(token.data(), token.data() + token.size(), number);
+        return ec == std::errc() && end == token.data() + token.size() && std::isfinite(number);
+    }
+
+    bool ParseString(std::string& value)
+    {
+        if (!Expect('"')) return false;
+        value.clear();
+        while (pos_ < text_.size())
+        {
+            const char c = text_[pos_++];
+            if (c == '"') return true;
+            if (c != '\\')
+            {
+                value += c;
+                continue;
+            }
+
+            if (pos_ >= text_.size()) return false;
+            switch (text_[pos_++])
+            {
+                case '"': value += '"'; break;
+                case '\\': value += '\\'; break;
+                case '/': value += '/'; break;
+                case 'b': value += '\b'; break;
+                case 'f': value += '\f'; break;
+                case 'n': value += '\n'; break;
+                case 'r': value += '\r'; break;
+                case 't': value += '\t'; break;
+                case 'u':
+                {
+                    // flags and room names are ASCII, anything else is rejected
+                    unsigned int code = 0;
+                    if (pos_ + 4 > text_.size()) return false;
+                    const auto [end, ec] =
+                        std::from_chars(text_.data() + pos_, text_.data() + pos_ + 4, code, 16);
+                    if (ec != std::errc() || end != text_.data() + pos_ + 4 || code > 0x7F)
+                        return false;
+                    value += static_cast<char>(code);
+                    pos_ += 4;
+                    break;
+                }
+                default:
+                    return false;
+            }
+        }
+        return false;
+    }
+
+    bool ParseStringArray(std::vector<std::string>& values)
+    {
+        values.clear();
+        if (!Expect('[')) return false;
+        if (Expect(']')) return true;
+        do
+        {
+            if (!ParseString(values.emplace_back())) return false;
+        } while (Expect(','));
+        return Expect(']');
+    }
+
+    std::string_view text_;
+    std::size_t pos_ = 0;
+};
+
+struct PendingJob
+{
+    DaemonJob job;
+    std::shared_ptr<DaemonClient> client;
+};
+
+// The jobs waiting for a worker. Workers block in Pop until there is a job or the queue is
+// closed and drained.
+class JobQueue
+{
+public:
+    void Push(PendingJob pending)
+    {
+        {
+            std::lock_guard lock(mutex_);
+            jobs_.push_back(std::move(pending));
+        }
+        ready_.notify_one();
+    }
+
+    bool Pop(PendingJob& pending)
+    {
+        std::unique_lock lock(mutex_);
+        ready_.wait(lock, [this] { return closed_ || !jobs_.empty(); });
+        if (jobs_.empty()) return false;
+        pending = std::move(jobs_.front());
+        jobs_.pop_front();
+        return true;
+    }
+
+    void Close()
+    {
+        {
+            std::lock_guard lock(mutex_);
+            closed_ = true;
+        }
+        ready_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<PendingJob> jobs_;
+    bool closed_ = false;
+};
+
+// Queues every job line, answering malformed ones right away.
+class JobReader
+{
+public:
+    explicit JobReader(JobQueue& queue)
+        : queue_(queue)
+    {
+    }
+
+    void Line(std::string_view line, const std::shared_ptr<DaemonClient>& client)
+    {
+        if (line.find_first_not_of(" \t\r") == std::string_view::npos) return;
+
+        PendingJob pending{DaemonJob{}, client};
+        std::string error;
+        if (!ParseDaemonJob(line, pending.job, error))
+        {
+            client->WriteLine("{\"id\":" + pending.job.id +
+                              ",\"event\":\"error\",\"message\":" + JsonString(error) + "}");
+            return;
+        }
+        pending.job.number = jobCount_++;
+        queue_.Push(std::move(pending));
+    }
+
+private:
+    JobQueue& queue_;
+    std::atomic<uint32_t> jobCount_ = 0;  // connections read in parallel
+};
+
+#ifdef __linux__
+volatile std::sig_atomic_t stopRequested = 0;
+
+void RequestStop(int)
+{
+    stopRequested = 1;
+}
+
+struct Connection
+{
+    std::shared_ptr<DaemonClient> client;  // outlives the connection while its jobs run
+    std::atomic<bool> finished = false;
+    std::thread reader;
+};
+
+// reads one connection's job lines until the client closes its end
+void ReadConnection(int fd, const std::shared_ptr<DaemonClient>& client, JobReader& reader)
+{
+    std::string buffer;
+    char chunk[4096];
+    for (ssize_t count; (count = read(fd, chunk, sizeof(chunk))) > 0;)
+    {
+        buffer.append(chunk, count);
+        std::size_t start = 0;
+        for (std::size_t end; (end = buffer.find('\n', start)) != std::string::npos;
+             start = end + 1)
+            reader.Line(std::string_view(buffer).substr(start, end - start), client);
+        buffer.erase(0, start);
+    }
+    if (!buffer.empty()) reader.Line(buffer, client);
+}
+
+bool ServeSocket(const std::string& path, JobReader& reader)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path))
+    {
+        std::cerr << "Socket path " << path << " is too long\n";
+        return false;
+    }
+    path.copy(address.sun_path, path.size());
+
+    const int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(path.c_str());  // a socket left behind by an earlier daemon
+    if (listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) ||
+        listen(listener, SOMAXCONN))
+    {
+        std::cerr << "Could not listen on " << path << "\n";
+        if (listener >= 0) close(listener);
+        return false;
+    }
+
+    std::signal(SIGINT, RequestStop);
+    std::signal(SIGTERM, RequestStop);
+
+    // poll with a timeout rather than block in accept, the signal may land on another thread
+    std::vector<std::unique_ptr<Connection>> connections;
+    pollfd pending{listener, POLLIN, 0};
+    while (!stopRequested)
+    {
+        std::erase_if(connections, [](const std::unique_ptr<Connection>& connection) {
+            if (!connection->finished) return false;
+            connection->reader.join();
+            return true;
+        });
+
+        if (poll(&pending, 1, 200) <= 0) continue;
+        const int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0) continue;
+
+        Connection& connection = *connections.emplace_back(std::make_unique<Connection>());
+        connection.client = std::make_shared<DaemonClient>(fd, true);
+        connection.reader = std::thread([fd, &connection, &reader] {
+            ReadConnection(fd, connection.client, reader);
+            connection.finished = true;
+        });
+    }
+
+    // stop taking jobs, the ones already queued still run and answer
+    for (const std::unique_ptr<Connection>& connection : connections)
+    {
+        shutdown(connection->client->Fd(), SHUT_RD);
+        connection->reader.join();
+    }
+    close(listener);
+    unlink(path.c_str());
+    return true;
+}
+#endif
+
+template <typename T>
+std::string FormatJsonNumber(T value)
+{
+    if (!std::isfinite(value)) return "null";
+    char buffer[32];
+    const auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    return std::string(buffer, end);
+}
+
+}  // namespace
+
+bool ParseDaemonJob(std::string_view line, DaemonJob& job, std::string& error)
+{
+    return JobParser(line).Parse(job, error);
+}
+
+std::string JsonString(std::string_view text)
+{
+    constexpr char HEX[] = "0123456789abcdef";
+
+    std::string quoted = "\"";
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+            quoted += {'\\', c};
+        else if (c == '\n')
+            quoted += "\\n";
+        else if (static_cast<unsigned char>(c) < 0x20)
+            quoted += {'\\', 'u', '0', '0', HEX[c >> 4], HEX[c & 0xF]};
+        else
+            quoted += c;
+    }
+    return quoted + "\"";
+}
+
+std::string JsonNumber(double value)
+{
+    return FormatJsonNumber(value);
+}
+
+std::string JsonNumber(float value)
+{
+    return FormatJsonNumber(value);
+}
+
+DaemonClient::~DaemonClient()
+{
+#ifdef __linux__
+    if (isSocket_) close(fd_);
+#endif
+}
+
+bool DaemonClient::WriteLine(std::string_view line)
+{
+#ifdef __linux__
+    std::lock_guard lock(mutex_);
+    std::string text(line);
+    text += '\n';
+    for (std::size_t written = 0; open_ && written < text.size();)
+    {
+        // MSG_NOSIGNAL, a client that hung up must not take the daemon down with SIGPIPE
+        const ssize_t count =
+            isSocket_ ? send(fd_, text.data() + written, text.size() - written, MSG_NOSIGNAL)
+                      : write(fd_, text.data() + written, text.size() - written);
+        if (count > 0)
+            written += count;
+        else if (count < 0 && errno != EINTR)
+            open_ = false;
+    }
+    return open_;
+#else
+    return false;
+#endif
+}
+
+bool ServeJobs(const std::string& endpoint, int threads, const DaemonHandler& handler)
+{
+#ifdef __linux__
+    JobQueue queue;
+    JobReader reader(queue);
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; i++)
+        workers.emplace_back([&] {
+            for (PendingJob pending; queue.Pop(pending);)
+                handler(pending.job, *pending.client);
+        });
+
+    bool served = true;
+    if (endpoint == "-")
+    {
+        const auto client = std::make_shared<DaemonClient>(STDOUT_FILENO, false);
+        for (std::string line; std::getline(std::cin, line);)
+            reader.Line(line, client);
+    }
+    else
+        served = ServeSocket(endpoint, reader);
+
+    queue.Close();
+    for (std::thread& worker : workers)
+        worker.join();
+    return served;
+#else
+    std::cerr << "--serve is only supported on Linux\n";
+    return false;
+#endif
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Server mode: as3 stays resident and runs jobs sent to it as JSON lines, so the room pools,
+// spec tables, worker threads and their arenas stay warm between jobs and nothing is written
+// under data/. A job is one line holding a flat object:
+//   {"id": "kitchen-1", "args": ["--generations", "200"], "seed": 42, "rooms": ["Living ..."]}
+// where args are as3 flags, seed is the master seed (random if left out) and rooms are lines
+// of a room spec file (the built-in rooms if left out). Only id is echoed back, in every line
+// of the job's response. The responses themselves are written by the driver (see RunDaemon).
+
+struct DaemonJob
+{
+    std::string id = "null";         // as JSON, so a string id keeps its quotes
+    std::vector<std::string> args;
+    std::optional<uint64_t> seed;
+    std::vector<std::string> rooms;  // room spec lines
+    uint32_t number = 0;             // order of arrival, used as the telemetry job
+};
+
+// Parses one job line. Returns false and fills error if the line is not a valid job.
+bool ParseDaemonJob(std::string_view line, DaemonJob& job, std::string& error);
+
+// text as a quoted JSON string
+std::string JsonString(std::string_view text);
+
+// shortest text that reads back as value, null if it isn't finite
+std::string JsonNumber(double value);
+std::string JsonNumber(float value);
+
+// One connection (or stdout), writes from several jobs may interleave but lines never do.
+class DaemonClient
+{
+public:
+    DaemonClient(int fd, bool isSocket)
+        : fd_(fd),
+          isSocket_(isSocket)
+    {
+    }
+    DaemonClient(const DaemonClient&) = delete;
+    DaemonClient& operator=(const DaemonClient&) = delete;
+    ~DaemonClient();
+
+    // writes line and a newline, returns false once the client has gone away
+    bool WriteLine(std::string_view line);
+
+    int Fd() const { return fd_; }
+
+private:
+    std::mutex mutex_;
+    int fd_;
+    bool isSocket_;  // sockets are closed with the client, stdout is not
+    bool open_ = true;
+};
+
+using DaemonHandler = std::function<void(const DaemonJob& job, DaemonClient& client)>;
+
+// Reads jobs from stdin (endpoint "-") or a Unix domain socket at the endpoint path and runs
+// them on threads worker threads, each job on one worker. Returns at the end of stdin, or on
+// SIGINT or SIGTERM when serving a socket, once the queued jobs have finished.
+// Returns false if the endpoint cannot be opened.
+bool ServeJobs(const std::string& endpoint, int threads, const DaemonHandler& handler);
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "Simd.hpp"
+#include "encoding.hpp"
+
+// Population diversity, measured on the packed binary room words every genome can produce
+// (see FittestIndividual), so the numbers are comparable across genomes and encodings.
+// Bit b of a population is an allele; its frequency is the fraction of individuals with b set.
+
+struct DiversityStatistics
+{
+    double meanHamming = 0.0;  // mean Hamming distance over all pairs of individuals, in bits
+    int uniqueGenomes = 0;     // distinct genomes, ignoring the vestigial x and y positions
+
+    // one entry per chromosome bit, room by room and most significant bit first
+    // (the order PrintPackedRooms prints them in)
+    std::vector<float> alleleFrequencies;
+};
+
+// length and width, the bits the objective actually looks at
+constexpr uint64_t EFFECTIVE_ROOM_MASK =
+    ROOM_WORD_MASK & ~((uint64_t{1} << (2 * FLOAT_BITWIDTH)) - 1);
+
+// Measures a population given as one row of packed room words per individual.
+// The allele counts come from the countAlleles kernel (see SimdKernels.hpp). The mean
+// pairwise Hamming distance then follows exactly from the counts (a bit set in c of N
+// individuals differs in c * (N - c) pairs), which is cheaper than sampling pairs and has
+// no sampling noise.
+inline DiversityStatistics MeasureDiversity(std::span<const uint64_t> rows, int individuals)
+{
+    DiversityStatistics diversity;
+    if (individuals == 0) return diversity;
+
+    const int words = static_cast<int>(rows.size()) / individuals;
+
+    // counts[w * 64 + bit] counts the individuals with that bit of word w set
+    std::vector<int> counts(words * 64, 0);
+    Kernels().countAlleles(rows.data(), individuals, words, counts.data());
+
+    const double pairs = individuals * (individuals - 1.0) / 2.0;
+    double differingPairs = 0.0;
+    diversity.alleleFrequencies.resize(words * ROOM_BITWIDTH);
+    for (int w = 0; w < words; w++)
+    {
+        for (int k = 0; k < ROOM_BITWIDTH; k++)
+        {
+            const int64_t count = counts[w * 64 + ROOM_BITWIDTH - 1 - k];
+            diversity.alleleFrequencies[w * ROOM_BITWIDTH + k] =
+                static_cast<float>(count) / individuals;
+            differingPairs += static_cast<double>(count) * (individuals - count);
+        }
+    }
+    diversity.meanHamming = pairs > 0.0 ? differingPairs / pairs : 0.0;
+
+    // count distinct hashes of the effective genomes in an open addressing table
+    // (0 marks an empty slot, a 64-bit collision between two genomes is vanishingly unlikely)
+    std::vector<uint64_t> table(std::bit_ceil(2u * individuals), 0);
+    const std::size_t slotMask = table.size() - 1;
+    for (int i = 0; i < individuals; i++)
+    {
+        uint64_t hash = 0;
+        for (int w = 0; w < words; w++)
+        {
+            hash = (hash ^ (rows[i * words + w] & EFFECTIVE_ROOM_MASK)) * 0x9E3779B97F4A7C15;
+            hash ^= hash >> 29;
+        }
+        hash |= 1;
+
+        std::size_t slot = hash & slotMask;
+        while (table[slot] != 0 && table[slot] != hash)
+            slot = (slot + 1) & slotMask;
+        if (table[slot] == 0)
+        {
+            table[slot] = hash;
+            diversity.uniqueGenomes++;
+        }
+    }
+
+    return diversity;
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Best individual of a generation, in a form every genome can produce:
+// one plain binary packed room word per room (see PackedChromosome).
+struct FittestIndividual
+{
+    std::vector<uint64_t> rooms;
+    float objective = 0.0f;
+    float fitness = 0.0f;
+};
+
+// The best individual of every generation of a run, stored as changes only.
+// Consecutive bests are mostly the same layout, or a few rooms apart, so a generation whose
+// best didn't change costs nothing, and one that did keeps only the room words that changed,
+// XORed with the previous best. Every KEYFRAME_INTERVAL-th change keeps all of its words
+// instead, so looking up one generation replays at most that many changes. Nothing is decoded
+// back into a FittestIndividual until someone asks for it.
+class FittestLog
+{
+public:
+    static constexpr int KEYFRAME_INTERVAL = 32;
+
+    // Generations are recorded in increasing order; a generation that is skipped, or
+    // anything after the last one recorded, repeats the best before it.
+    void Record(int generation, std::span<const uint64_t> rooms, float objective, float fitness)
+    {
+        if (!changes_.empty() && objective == changes_.back().objective &&
+            fitness == changes_.back().fitness &&
+            std::equal(rooms.begin(), rooms.end(), last_.begin(), last_.end()))
+            return;
+
+        Change change{generation, objective, fitness, static_cast<uint32_t>(words_.size()),
+                      static_cast<uint32_t>(roomIndices_.size()), 0};
+        if (IsKeyframe(changes_.size()))
+        {
+            words_.insert(words_.end(), rooms.begin(), rooms.end());
+            change.count = static_cast<uint32_t>(rooms.size());
+        }
+        else
+        {
+            for (std::size_t r = 0; r < rooms.size(); r++)
+            {
+                if (rooms[r] == last_[r]) continue;
+                words_.push_back(rooms[r] ^ last_[r]);
+                roomIndices_.push_back(static_cast<uint32_t>(r));
+                change.count++;
+            }
+        }
+        last_.assign(rooms.begin(), rooms.end());
+        changes_.push_back(change);
+    }
+
+    // The best of the given generation. Empty before the first generation recorded.
+    FittestIndividual At(int generation) const
+    {
+        const auto after = std::upper_bound(
+            changes_.begin(), changes_.end(), generation,
+            [](int gen, const Change& change) { return gen < change.generation; });
+        FittestIndividual individual;
+        const std::size_t end = after - changes_.begin();
+        if (end == 0) return individual;
+
+        for (std::size_t i = (end - 1) / KEYFRAME_INTERVAL * KEYFRAME_INTERVAL; i < end; i++)
+            Apply(i, individual);
+        return individual;
+    }
+
+    // Calls fn(generation, individual) for every generation at which the best changed, up to
+    // and including last.
+    template <typename Fn>
+    void ForEachChange(int last, Fn fn) const
+    {
+        FittestIndividual individual;
+        for (std::size_t i = 0; i < changes_.size() && changes_[i].generation <= last; i++)
+        {
+            Apply(i, individual);
+            fn(changes_[i].generation, static_cast<const FittestIndividual&>(individual));
+        }
+    }
+
+    // Calls fn(generation, individual) for every generation from the first recorded one to
+    // last, decoding each change once.
+    template <typename Fn>
+    void ForEachGeneration(int last, Fn fn) const
+    {
+        if (changes_.empty()) return;
+
+        FittestIndividual individual;
+        std::size_t next = 0;
+        for (int gen = changes_[0].generation; gen <= last; gen++)
+        {
+            for (; next < changes_.size() && changes_[next].generation <= gen; next++)
+                Apply(next, individual);
+            fn(gen, static_cast<const FittestIndividual&>(individual));
+        }
+    }
+
+    // The first generation up to last with the highest fitness, -1 if none was recorded.
+    // The fittest generation always starts a change, so nothing is decoded.
+    int FittestGeneration(int last) const
+    {
+        int fittest = -1;
+        float maxFitness = 0.0f;
+        for (const Change& change : changes_)
+        {
+            if (change.generation > last) break;
+            if (fittest < 0 || change.fitness > maxFitness)
+            {
+                fittest = change.generation;
+                maxFitness = change.fitness;
+            }
+        }
+        return fittest;
+    }
+
+    std::size_t ChangeCount() const { return changes_.size(); }
+
+    std::size_t BytesUsed() const
+    {
+        return changes_.capacity() * sizeof(Change) + words_.capacity() * sizeof(uint64_t) +
+               roomIndices_.capacity() * sizeof(uint32_t) + last_.capacity() * sizeof(uint64_t);
+    }
+
+private:
+    struct Change
+    {
+        int generation;
+        float objective;
+        float fitness;
+        uint32_t wordBegin;   // into words_
+        uint32_t indexBegin;  // into roomIndices_, deltas only
+        uint32_t count;       // words, all of the rooms for a keyframe
+    };
+
+    static bool IsKeyframe(std::size_t change) { return change % KEYFRAME_INTERVAL == 0; }
+
+    // turns the best before change i into the best at change i
+    void Apply(std::size_t i, FittestIndividual& individual) const
+    {
+        const Change& change = changes_[i];
+        const uint64_t* words = words_.data() + change.wordBegin;
+        if (IsKeyframe(i))
+            individual.rooms.assign(words, words + change.count);
+        else
+            for (uint32_t k = 0; k < change.count; k++)
+                individual.rooms[roomIndices_[change.indexBegin + k]] ^= words[k];
+        individual.objective = change.objective;
+        individual.fitness = change.fitness;
+    }
+
+    std::vector<Change> changes_;
+    std::vector<uint64_t> words_;
+    std::vector<uint32_t> roomIndices_;
+    std::vector<uint64_t> last_;  // the most recent best, to diff the next one against
+};
@@ -0,0 +1,1234 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <random>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "Arena.hpp"
+#include "Diversity.hpp"
+#include "FittestLog.hpp"
+#include "LocalSearch.hpp"
+#include "Rooms.hpp"
+#include "Simd.hpp"
+#include "Telemetry.hpp"
+#include "encoding.hpp"
+
+// The GA engine is a template over a set of policy classes, one per operator.
+// Every policy is a plain (non-virtual) class, so each combination of policies
+// compiles into its own fully inlined engine.
+//
+//   Genome    - chromosome type, initialization, distance and conversion for reporting
+//               (it may carry runtime state such as the room specs, so the engine keeps a copy)
+//               (an optional PackRooms(chromosome, span) lets the diversity stats skip allocating)
+//   Selection - Prepare(pop) once per generation, then Pick(rng, pop) -> parent index
+//   Crossover - produces two children from two parents, applying the Mutation policy
+//   Mutation  - mutates a single bit
+//   Evaluator - maps a chromosome to its objective and fitness
+//               (it may update per-chromosome caches, so it receives a mutable chromosome)
+//   Rng       - uniform random bit generator
+//
+// The populations live in the calling thread's Arena (see Arena.hpp), which each run
+// rewinds and reuses, so population size is only limited by memory.
+
+// defaults, each one can be changed per run through GAConfig
+constexpr int NUM_GENERATIONS = 50;
+constexpr int GENERATION_SIZE = 100;  // population size
+constexpr double CROSSOVER_PROB = 0.7;
+constexpr double MUTATION_PROB = 0.001;
+
+// Success-based operator rates (GAConfig::adaptiveRates), see AdaptRates. A child succeeds
+// when it is fitter than both of its parents.
+constexpr double TARGET_SUCCESS_RATE = 0.2;     // the 1/5 rule
+constexpr double MUTATION_RATE_FACTOR = 1.25;   // per generation, up or down
+constexpr double CROSSOVER_RATE_STEP = 0.05;    // per generation, up or down
+constexpr double MIN_ADAPTIVE_MUTATION_PROB = 1e-4;
+constexpr double MAX_ADAPTIVE_MUTATION_PROB = 0.1;
+constexpr double MIN_ADAPTIVE_CROSSOVER_PROB = 0.2;
+constexpr double MAX_ADAPTIVE_CROSSOVER_PROB = 0.95;  // some pairs stay uncrossed to compare
+
+enum class StopReason
+{
+    GENERATION_LIMIT,
+    TARGET_FITNESS,
+    STALLED,
+    LOW_DIVERSITY
+};
+
+// The search algorithm: the GA of this file, or one of the backends in Optimizers.hpp
+enum class OptimizerKind
+{
+    GA,
+    DIFFERENTIAL_EVOLUTION,
+    SIMULATED_ANNEALING,
+    EVOLUTION_STRATEGY  // (mu + lambda)
+};
+
+enum class GenomeKind
+{
+    BITSTRING,
+    GRID
+};
+
+enum class CrossoverScheme
+{
+    N_POINT,       // cut points anywhere
+    GENE_ALIGNED,  // cut points only between 10-bit genes
+    ROOM_ALIGNED,  // cut points only between 40-bit rooms
+    UNIFORM
+};
+
+enum class SelectionScheme
+{
+    ROULETTE,
+    TOURNAMENT,
+    RANK
+};
+
+// What the memetic stage does with the result of a hill climb (see LocalSearch.hpp)
+enum class LocalSearchMode
+{
+    NONE,
+    LAMARCKIAN,  // the refined chromosome replaces the individual
+    BALDWINIAN   // the individual keeps its chromosome but takes the refined fitness
+};
+
+// How the spec genome draws the sizes of its initial rooms (see RoomPool.hpp)
+enum class InitSampling
+{
+    REJECTION,  // draw sizes until one fits the spec
+    POOL,       // uniform over the room's precomputed valid sizes
+    STRATIFIED  // Latin hypercube over the valid sizes, one stratum per individual
+};
+
+// Optional behaviour of a GA run.
+// The defaults reproduce the plain generational GA (no elitism, no early termination).
+struct GAConfig
+{
+    int generations = NUM_GENERATIONS;
+    int populationSize = GENERATION_SIZE;
+    double crossoverProb = CROSSOVER_PROB;
+    double mutationProb = MUTATION_PROB;  // per bit, bitstring genome only
+
+    // number of fittest individuals copied unchanged into the next generation
+    int elitismCount = 0;
+
+    GenomeKind genome = GenomeKind::BITSTRING;
+    GeneEncoding encoding = GeneEncoding::BINARY;  // only used by the bitstring genome
+
+    // bitstring genome crossover
+    CrossoverScheme crossover = CrossoverScheme::N_POINT;
+    int crossoverPoints = 1;  // ignored by uniform crossover
+
+    // integer grid genome operators
+    double sbxDistributionIndex = 20.0;  // larger values keep children closer to their parents
+    double gridMutationProb = 0.01;      // per gene
+    double gridMutationSigma = 2.0;      // standard deviation in grid steps (0.1 units)
+
+    SelectionScheme selection = SelectionScheme::ROULETTE;
+    int tournamentSize = 2;     // individuals drawn per tournament
+    double rankPressure = 1.5;  // expected offspring of the best individual, in [1, 2]
+
+    // stopping criteria, a negative value disables the criterion
+    float targetFitness = -1.0f;  // stop once the best fitness reaches this value
+    int stallGenerations = -1;    // stop after this many generations without improvement
+    float minDiversity = -1.0f;   // stop once the population diversity drops below this value
+
+    // record DiversityStatistics every generation, one extra pass over the population
+    bool diversityStats = false;
+
+    // memetic stage, hill climbs the fittest individuals of every generation
+    LocalSearchMode localSearch = LocalSearchMode::NONE;
+    int localSearchTopK = 1;     // individuals refined per generation
+    int localSearchBudget = 64;  // evaluations per refined individual
+
+    // bitstring genome only, the grid genome always rejection samples
+    InitSampling initSampling = InitSampling::POOL;
+
+    // adapt the mutation and crossover rates every generation, from the rates above (or the
+    // grid genome's), by how often children beat their parents
+    bool adaptiveRates = false;
+
+    // The other optimizers all search the integer grid (see Optimizers.hpp), with
+    // populationSize evaluations per generation for SA and DE, and esOffspring for the ES.
+    OptimizerKind optimizer = OptimizerKind::GA;
+    double deWeight = 0.5;          // F, the scale of the difference vector
+    double deCrossoverProb = 0.9;   // CR, per gene
+    double saTemperature = 0.5;     // initial, in fitness units, cooled 1000-fold by the end
+    int esOffspring = GENERATION_SIZE;  // lambda, mu is the population size
+};
+
+struct EvaluationResult
+{
+    float objective;
+    float fitness;
+};
+
+template <typename ChromosomeType>
+struct BasicIndividual
+{
+    ChromosomeType chromosome;
+    float objective;
+    float fitness;
+};
+
+template <typename ChromosomeType>
+using BasicPopulation = ArenaArray<BasicIndividual<ChromosomeType>>;
+
+using Individual = BasicIndividual<Chromosome>;
+using Population = BasicPopulation<Chromosome>;
+using ProbDist = std::vector<double>;
+using RankOrder = std::vector<int>;
+
+inline std::vector<uint64_t> PackedRooms(const PackedChromosome& chromosome)
+{
+    return std::vector<uint64_t>(chromosome.begin(), chromosome.end());
+}
+
+// Every per-generation vector holds generations + 1 entries (see ResizeStatistics).
+struct Statistics
+{
+    std::random_device::result_type seed;
+    FittestLog fittest;  // the best individual of each generation, see FittestLog
+
+    // the last generation that was actually run, and why the run stopped there
+    // entries past lastGeneration repeat the final generation's values
+    int lastGeneration = NUM_GENERATIONS;
+    StopReason stopReason = StopReason::GENERATION_LIMIT;
+
+    std::size_t populationBytes = 0;  // arena memory used by the populations of this run
+
+    // evaluations spent up to and including each generation, by the GA itself and by the
+    // memetic stage, so runs can be compared at equal evaluation budgets
+    std::vector<int64_t> evaluations;
+    std::vector<int64_t> localSearchEvaluations;
+
+    // The +1 is so we include the initial generation
+    std::vector<float> minFitnesses;
+    std::vector<float> maxFitnesses;
+    std::vector<float> avgFitnesses;
+
+    std::vector<float> minObjective;
+    std::vector<float> maxObjective;
+    std::vector<float> avgObjective;
+
+    // the operator rates each generation was bred with, constant unless adaptiveRates is set
+    std::vector<float> mutationRates;
+    std::vector<float> crossoverRates;
+
+    // empty unless GAConfig::diversityStats is set
+    std::vector<DiversityStatistics> diversity;
+};
+
+inline void ResizeStatistics(Statistics& stats, int generations)
+{
+    stats.lastGeneration = generations;
+    stats.minFitnesses.resize(generations + 1);
+    stats.maxFitnesses.resize(generations + 1);
+    stats.avgFitnesses.resize(generations + 1);
+    stats.minObjective.resize(generations + 1);
+    stats.maxObjective.resize(generations + 1);
+    stats.avgObjective.resize(generations + 1);
+    stats.evaluations.resize(generations + 1);
+    stats.localSearchEvaluations.resize(generations + 1);
+    stats.mutationRates.resize(generations + 1);
+    stats.crossoverRates.resize(generations + 1);
+}
+
+inline std::string_view OptimizerKindToString(OptimizerKind optimizer)
+{
+    switch (optimizer)
+    {
+        case OptimizerKind::GA:
+            return "GA";
+        case OptimizerKind::DIFFERENTIAL_EVOLUTION:
+            return "DE";
+        case OptimizerKind::SIMULATED_ANNEALING:
+            return "SA";
+        case OptimizerKind::EVOLUTION_STRATEGY:
+            return "ES";
+        default:
+            return "<UNKNOWN OPTIMIZER>";
+    }
+}
+
+inline std::string_view StopReasonToString(StopReason reason)
+{
+    switch (reason)
+    {
+        case StopReason::GENERATION_LIMIT:
+            return "generation limit";
+        case StopReason::TARGET_FITNESS:
+            return "target fitness reached";
+        case StopReason::STALLED:
+            return "no improvement";
+        case StopReason::LOW_DIVERSITY:
+            return "low diversity";
+        default:
+            return "<UNKNOWN STOP REASON>";
+    }
+}
+
+// Marks the run as stopped after lastGen.
+// The remaining generations are filled with the final values
+// so that the per-generation averages across trials stay well defined.
+inline void FreezeStatistics(Statistics& stats, int lastGen, StopReason reason)
+{
+    stats.lastGeneration = lastGen;
+    stats.stopReason = reason;
+
+    for (int i = lastGen + 1; i < stats.maxFitnesses.size(); i++)
+    {
+        stats.minFitnesses[i] = stats.minFitnesses[lastGen];
+        stats.maxFitnesses[i] = stats.maxFitnesses[lastGen];
+        stats.avgFitnesses[i] = stats.avgFitnesses[lastGen];
+        stats.minObjective[i] = stats.minObjective[lastGen];
+        stats.maxObjective[i] = stats.maxObjective[lastGen];
+        stats.avgObjective[i] = stats.avgObjective[lastGen];
+        stats.evaluations[i] = stats.evaluations[lastGen];
+        stats.localSearchEvaluations[i] = stats.localSearchEvaluations[lastGen];
+        stats.mutationRates[i] = stats.mutationRates[lastGen];
+        stats.crossoverRates[i] = stats.crossoverRates[lastGen];
+        if (!stats.diversity.empty()) stats.diversity[i] = stats.diversity[lastGen];
+    }
+}
+
+// Contribution of the room at the given index to the objective function.
+inline float RoomObjective(const Room& room, int index)
+{
+    return DoesRoomFitConstraints(room) ? RoomCost(room) : INVALID_OBJECTIVE[index];
+}
+
+inline EvaluationResult EvaluateIndividual(const RoomSet& rooms)
+{
+    // a further modification is needed here
+    // invalid rooms should be assessed on an individual basis
+    // e.g a layout with one invalid room should be more fit than one with five invalid rooms
+    // an invalid room with have an objective value of ${ROOM}_AREA.high
+    // (the maximum area and thus maximum cost)
+
+    float objective = 0.0f;
+    for (int i = 0; i < NUM_ROOMS; i++)
+        objective += RoomObjective(rooms[i], i);
+    float fitness = ObjectiveToFitness(objective);
+
+    EvaluationResult ret;
+    ret.objective = objective;
+    ret.fitness = fitness;
+    return ret;
+}
+
+template <typename Rng>
+float GenerateFloatInRange(Rng& generator, const Range<float> range)
+{
+    // since we are dealing with discrete float values,
+    // we want to generate them as a discrete type first
+    constexpr float offset = 10.0f;
+    std::uniform_int_distribution<int> dist(range.low * offset, range.high * offset);
+    int value = dist(generator);
+    return value / offset;
+}
+
+// Generates a random RoomSet in which every room satisfies its constraints.
+template <typename Rng>
+RoomSet InitializeRoomSet(Rng& generator)
+{
+    constexpr Range<float> defaultRange(0.0f, 102.3f);
+
+    // zeroed, so a pass of the loops below that assigns no size is rejected instead of
+    // reading garbage (that made seeded runs irreproducible)
+    RoomSet roomSet{};
+
+    // initialize each room with valid values
+    // Living, Kitchen, Bath, Hall, Bed1, Bed2, Bed3
+    roomSet[0].type = RoomType::LIVING;
+    do
+    {
+        // fixed proportions must be generated in a different way
+        // this prevents us from spinning our wheels in this loop for a Very Long Time
+        float tmpLength = GenerateFloatInRange(generator, LIVING_LENGTH);
+        float tmpWidth = GenerateFloatInRange(generator, LIVING_WIDTH);
+        float propLength = LIVING_PROPORTION * tmpWidth;
+        float propWidth = LIVING_PROPORTION * tmpLength;
+
+        // the selection process is biased towards longer width, but whatever
+        if (LIVING_LENGTH.Contains(tmpLength) && LIVING_WIDTH.Contains(propWidth))
+        {
+            roomSet[0].length = tmpLength;
+            roomSet[0].width = propWidth;
+        }
+        else if (LIVING_LENGTH.Contains(propLength) && LIVING_WIDTH.Contains(tmpWidth))
+        {
+            roomSet[0].length = propLength;
+            roomSet[0].width = propWidth;
+        }
+    } while (!DoesRoomFitConstraints(roomSet[0]));
+
+    roomSet[1].type = RoomType::KITCHEN;
+    do
+    {
+        roomSet[1].length = GenerateFloatInRange(generator, KITCHEN_LENGTH);
+        roomSet[1].width = GenerateFloatInRange(generator, KITCHEN_WIDTH);
+    } while (!DoesRoomFitConstraints(roomSet[1]));
+
+    roomSet[2].type = RoomType::BATH;
+    roomSet[2].length = BATH_LENGTH;
+    roomSet[2].width = BATH_WIDTH;
+
+    roomSet[3].type = RoomType::HALL;
+    do
+    {
+        roomSet[3].length = HALL_LENGTH;
+        roomSet[3].width = GenerateFloatInRange(generator, HALL_WIDTH);
+    } while (!DoesRoomFitConstraints(roomSet[3]));
+
+    roomSet[4].type = RoomType::BED1;
+    do
+    {
+        float tmpLength = GenerateFloatInRange(generator, BED1_LENGTH);
+        float tmpWidth = GenerateFloatInRange(generator, BED1_WIDTH);
+        float propLength = BED1_PROPORTION * tmpWidth;
+        float propWidth = BED1_PROPORTION * tmpLength;
+
+        roomSet[4].length = GenerateFloatInRange(generator, BED1_LENGTH);
+        roomSet[4].width = GenerateFloatInRange(generator, BED1_WIDTH);
+
+        if (BED1_LENGTH.Contains(tmpLength) && BED1_WIDTH.Contains(propWidth))
+        {
+            roomSet[4].length = tmpLength;
+            roomSet[4].width = propWidth;
+        }
+        else if (BED1_LENGTH.Contains(propLength) && BED1_WIDTH.Contains(tmpWidth))
+        {
+            roomSet[4].length = propLength;
+            roomSet[4].width = propWidth;
+        }
+    } while (!DoesRoomFitConstraints(roomSet[4]));
+
+    roomSet[5].type = RoomType::BED2;
+    do
+    {
+        float tmpLength = GenerateFloatInRange(generator, BED2_LENGTH);
+        float tmpWidth = GenerateFloatInRange(generator, BED2_WIDTH);
+        float propLength = BED2_PROPORTION * tmpWidth;
+        float propWidth = BED2_PROPORTION * tmpLength;
+
+        roomSet[5].length = GenerateFloatInRange(generator, BED2_LENGTH);
+        roomSet[5].width = GenerateFloatInRange(generator, BED2_WIDTH);
+
+        if (BED2_LENGTH.Contains(tmpLength) && BED2_WIDTH.Contains(propWidth))
+        {
+            roomSet[5].length = tmpLength;
+            roomSet[5].width = propWidth;
+        }
+        else if (BED2_LENGTH.Contains(propLength) && BED2_WIDTH.Contains(tmpWidth))
+        {
+            roomSet[5].length = propLength;
+            roomSet[5].width = propWidth;
+        }
+    } while (!DoesRoomFitConstraints(roomSet[5]));
+
+    roomSet[6].type = RoomType::BED3;
+    do
+    {
+        float tmpLength = GenerateFloatInRange(generator, BED3_LENGTH);
+        float tmpWidth = GenerateFloatInRange(generator, BED3_WIDTH);
+        float propLength = BED3_PROPORTION * tmpWidth;
+        float propWidth = BED3_PROPORTION * tmpLength;
+
+        roomSet[6].length = GenerateFloatInRange(generator, BED3_LENGTH);
+        roomSet[6].width = GenerateFloatInRange(generator, BED3_WIDTH);
+
+        if (BED3_LENGTH.Contains(tmpLength) && BED3_WIDTH.Contains(propWidth))
+        {
+            roomSet[6].length = tmpLength;
+            roomSet[6].width = propWidth;
+        }
+        else if (BED3_LENGTH.Contains(propLength) && BED3_WIDTH.Contains(tmpWidth))
+        {
+            roomSet[6].length = propLength;
+            roomSet[6].width = propWidth;
+        }
+    } while (!DoesRoomFitConstraints(roomSet[6]));
+
+    // we actually don't care about position at all
+    // so let's just generate one randomly and call it a day
+    // (because I don't want to re-write my encoders/decoders)
+    for (Room& room : roomSet)
+    {
+        room.x = GenerateFloatInRange(generator, defaultRange);
+        room.y = GenerateFloatInRange(generator, defaultRange);
+    }
+
+    return roomSet;
+}
+
+template <typename Rng>
+void InitializeIndividual(Rng& generator, Individual& x,
+                          GeneEncoding encoding = GeneEncoding::BINARY)
+{
+    x.chromosome = EncodeChromosome(InitializeRoomSet(generator), encoding);
+}
+
+// ===== Genome policies =====
+
+// The original 280-bit, one byte per bit chromosome, with each gene in the given encoding.
+template <GeneEncoding Encoding = GeneEncoding::BINARY>
+struct BitstringGenome
+{
+    using Chromosome = ::Chromosome;
+
+    template <typename Rng>
+    static void Initialize(Rng& generator, BasicIndividual<Chromosome>& x)
+    {
+        InitializeIndividual(generator, x, Encoding);
+    }
+
+    // number of loci, used to normalize Distance
+    static constexpr int Length() { return CHROMOSOME_BITWIDTH; }
+
+    // Hamming distance
+    static int Distance(const Chromosome& a, const Chromosome& b)
+    {
+        int differingBits = 0;
+        for (int i = 0; i < CHROMOSOME_BITWIDTH; i++)
+            differingBits += a[i] != b[i];
+        return differingBits;
+    }
+
+    // statistics always hold plain binary chromosomes
+    static std::vector<uint64_t> ToPackedRooms(const Chromosome& chromosome)
+    {
+        if constexpr (Encoding == GeneEncoding::GRAY)
+            return PackedRooms(PackChromosome(GrayToBinary(chromosome)));
+        return PackedRooms(PackChromosome(chromosome));
+    }
+};
+
+// ===== Selection policies =====
+
+// Fitness-proportionate selection over a cumulative probability distribution.
+struct RouletteSelection
+{
+    ProbDist cdf;
+
+    template <typename Pop>
+    void Prepare(const Pop& pop)
+    {
+        cdf.resize(pop.size());
+
+        double totalFitness = 0.0;
+        for (const auto& indiv : pop)
+            totalFitness += indiv.fitness;
+
+        // if the total fitness is 0, the entire probability distribution will be 0s
+        // to prevent this, we instead return a uniform CDF.
+        if (totalFitness == 0.0f)
+        {
+            float accumulator = 0.1f;
+            for (int i = 0; i < cdf.size(); i++)
+            {
+                cdf[i] = accumulator;
+                accumulator += 0.1f;
+            }
+            return;
+        }
+
+        double accumulator = 0.0;
+        for (int i = 0; i < pop.size(); i++)
+        {
+            accumulator += pop[i].fitness / totalFitness;
+            cdf[i] = accumulator;
+        }
+    }
+
+    // binary search for the first entry >= prob, so large populations stay O(log n) per pick
+    template <typename Rng, typename Pop>
+    int Pick(Rng& generator, const Pop& pop) const
+    {
+        std::uniform_real_distribution<double> dist(0.0, 1.0);
+        double prob = dist(generator);
+        auto it = std::lower_bound(cdf.begin(), cdf.end(), prob);
+
+        // floating point round-off can leave the last entry slightly below 1.0
+        if (it == cdf.end()) return static_cast<int>(cdf.size()) - 1;
+        return static_cast<int>(it - cdf.begin());
+    }
+};
+
+// k-way tournament: each parent is the fittest of k individuals drawn with replacement.
+// Costs O(k) per parent and needs no per-generation preprocessing.
+struct TournamentSelection
+{
+    int tournamentSize = 2;
+
+    template <typename Pop>
+    void Prepare(const Pop&)
+    {
+    }
+
+    template <typename Rng, typename Pop>
+    int Pick(Rng& generator, const Pop& pop) const
+    {
+        std::uniform_int_distribution<int> dist(0, static_cast<int>(pop.size()) - 1);
+        int winner = dist(generator);
+        for (int j = 1; j < tournamentSize; j++)
+        {
+            int challenger = dist(generator);
+            if (pop[challenger].fitness > pop[winner].fitness) winner = challenger;
+        }
+        return winner;
+    }
+};
+
+// Linear rank selection.
+// Rank r (0 = least fit) is chosen with probability (2 - s + 2(s - 1) r / (N - 1)) / N,
+// where s is the selection pressure. Instead of building a CDF over the ranks,
+// the rank is drawn by inverting the (continuous) linear CDF directly.
+struct RankSelection
+{
+    double pressure = 1.5;
+    RankOrder ranks;  // indices of the population ordered from least to most fit
+
+    template <typename Pop>
+    void Prepare(const Pop& pop)
+    {
+        ranks.resize(pop.size());
+        for (int i = 0; i < ranks.size(); i++)
+            ranks[i] = i;
+
+        std::sort(ranks.begin(), ranks.end(),
+                  [&](int a, int b) { return pop[a].fitness < pop[b].fitness; });
+    }
+
+    template <typename Rng, typename Pop>
+    int Pick(Rng& generator, const Pop&) const
+    {
+        std::uniform_real_distribution<double> dist(0.0, 1.0);
+
+        // F(x) = (2 - s)x + (s - 1)x^2 over the normalized rank x in [0, 1]
+        const double a = pressure - 1.0;
+        const double b = 2.0 - pressure;
+
+        double u = dist(generator);
+        double x = a == 0.0 ? u : (-b + std::sqrt(b * b + 4.0 * a * u)) / (2.0 * a);
+        const int size = static_cast<int>(ranks.size());
+        int rank = static_cast<int>(x * size);
+        rank = std::clamp(rank, 0, size - 1);
+        return ranks[rank];
+    }
+};
+
+// ===== Mutation policies =====
+
+struct BitFlipMutation
+{
+    double probability = MUTATION_PROB;
+
+    template <typename Rng>
+    uint8_t operator()(Rng& generator, uint8_t bit) const
+    {
+        std::uniform_real_distribution<double> dist(0.0, 1.0);
+        double prob = dist(generator);
+        if (prob <= probability) return !bit;
+        return bit;
+    }
+};
+
+// ===== Crossover policies =====
+
+// Single-point crossover, mutating every bit as it is copied into the children.
+// Like every crossover policy it returns whether the parents were actually recombined.
+struct SinglePointCrossover
+{
+    double probability = CROSSOVER_PROB;
+
+    template <typename Rng, typename Mutation>
+    bool operator()(Rng& generator, const Mutation& mutate, const Chromosome& parent0,
+                    const Chromosome& parent1, Chromosome& child0, Chromosome& child1) const
+    {
+        std::uniform_real_distribution<double> dist(0.0, 1.0);
+
+        double prob = dist(generator);
+        if (prob <= probability)
+        {
+            std::uniform_int_distribution<int> distInt(0, CHROMOSOME_BITWIDTH - 1);
+            int crossoverIndex = distInt(generator);
+
+            for (int i = 0; i < crossoverIndex; i++)
+            {
+                child0[i] = mutate(generator, parent0[i]);
+                child1[i] = mutate(generator, parent1[i]);
+            }
+            for (int i = crossoverIndex; i < CHROMOSOME_BITWIDTH; i++)
+            {
+                child0[i] = mutate(generator, parent1[i]);
+                child1[i] = mutate(generator, parent0[i]);
+            }
+            return true;
+        }
+
+        for (int i = 0; i < CHROMOSOME_BITWIDTH; i++)
+        {
+            child0[i] = mutate(generator, parent0[i]);
+            child1[i] = mutate(generator, parent1[i]);
+        }
+        return false;
+    }
+};
+
+// ===== Evaluator policies =====
+
+template <GeneEncoding Encoding = GeneEncoding::BINARY>
+struct RoomSetEvaluator
+{
+    EvaluationResult operator()(const Chromosome& chromosome) const
+    {
+        return EvaluateIndividual(DecodeChromosome(chromosome, Encoding));
+    }
+};
+
+// ===== Per-generation bookkeeping, shared with the other optimizers (Optimizers.hpp) =====
+
+// Fills generation gen of stats from a population of members with an objective, a fitness
+// and a chromosome of the genome. Returns the index of the fittest individual.
+// The objectives and fitnesses are gathered into scratch (two floats per individual) and
+// reduced by the reduce kernel (see SimdKernels.hpp).
+template <typename Genome, typename Population>
+int RecordGeneration(Statistics& stats, int gen, const Genome& genome,
+                     const Population& population, ArenaArray<float>& scratch)
+{
+    const std::size_t size = population.size();
+    float* objectives = scratch.begin();
+    float* fitnesses = scratch.begin() + size;
+    for (std::size_t i = 0; i < size; i++)
+    {
+        objectives[i] = population[i].objective;
+        fitnesses[i] = population[i].fitness;
+    }
+
+    const SimdKernels& kernels = Kernels();
+    const SimdReduction objective = kernels.reduce(objectives, size);
+    const SimdReduction fitness = kernels.reduce(fitnesses, size);
+    const int fittestIndex = static_cast<int>(fitness.maxIndex);
+
+    stats.minObjective[gen] = objective.min;
+    stats.maxObjective[gen] = objective.max;
+    stats.avgObjective[gen] = objective.sum / size;
+
+    stats.minFitnesses[gen] = fitness.min;
+    stats.maxFitnesses[gen] = fitness.max;
+    stats.avgFitnesses[gen] = fitness.sum / size;
+
+    const auto& fittest = population[fittestIndex];
+    stats.fittest.Record(gen, genome.ToPackedRooms(fittest.chromosome), fittest.objective,
+                         fittest.fitness);
+
+    return fittestIndex;
+}
+
+// Mean distance between each individual and the reference individual,
+// normalized to the range [0, 1].
+template <typename Genome, typename Population>
+float PopulationDiversity(const Genome& genome, const Population& population, int referenceIndex)
+{
+    const auto& reference = population[referenceIndex].chromosome;
+
+    int distance = 0;
+    for (const auto& individual : population)
+        distance += genome.Distance(individual.chromosome, reference);
+
+    return static_cast<float>(distance) / (population.size() * genome.Length());
+}
+
+// The stopping criteria of the config against gen, the generation just produced, which
+// returns GENERATION_LIMIT to carry on. diversity() is only called if minDiversity is set.
+template <typename DiversityFn>
+StopReason CheckStopCriteria(const GAConfig& config, const Statistics& stats, int gen,
+                             int lastImprovement, DiversityFn diversity)
+{
+    if (config.targetFitness >= 0.0f && stats.maxFitnesses[gen] >= config.targetFitness)
+        return StopReason::TARGET_FITNESS;
+    if (config.stallGenerations > 0 && gen - lastImprovement >= config.stallGenerations)
+        return StopReason::STALLED;
+    if (config.minDiversity >= 0.0f && diversity() < config.minDiversity)
+        return StopReason::LOW_DIVERSITY;
+    return StopReason::GENERATION_LIMIT;
+}
+
+// ===== Engine =====
+
+// An operator policy with a rate the engine can adapt (GAConfig::adaptiveRates).
+template <typename Policy>
+concept RatedPolicy = requires(Policy policy) { policy.probability = 0.5; };
+
+template <typename Genome, typename Selection, typename Crossover, typename Mutation,
+          typename Evaluator, typename Rng = std::mt19937>
+class GeneticAlgorithm
+{
+public:
+    using GenomeType = typename Genome::Chromosome;
+    using Member = BasicIndividual<GenomeType>;
+    using Pop = BasicPopulation<GenomeType>;
+
+    GeneticAlgorithm(const GAConfig& config, Selection selection = {}, Crossover crossover = {},
+                     Mutation mutation = {}, Evaluator evaluator = {}, Genome genome = {})
+        : config_(config),
+          genome_(genome),
+          selection_(selection),
+          crossover_(crossover),
+          mutation_(mutation),
+          evaluator_(evaluator)
+    {
+        if constexpr (RatedPolicy<Mutation>) mutationProb_ = mutation.probability;
+        if constexpr (RatedPolicy<Crossover>) crossoverProb_ = crossover.probability;
+    }
+
+    Statistics Run(typename Rng::result_type seed)
+    {
+        // everything a trial holds lives in the arena and is released when Run returns
+        Arena& arena = ThreadArena();
+        arena.Reset();
+
+        Trial trial = StartTrial(seed, arena, ThreadTelemetry());
+        do
+        {
+            for (Member& individual : trial.pending)
+                Evaluate(individual);
+        } while (Advance(trial));
+
+        trial.stats.populationBytes = arena.BytesUsed();
+        return std::move(trial.stats);
+    }
+
+    // Runs one trial per seed, all advancing a generation at a time together. Every trial
+    // breeds its next generation, then the offspring of all of them are evaluated as one
+    // batch (EvaluateAll), so a batch holds seeds.size() populations rather than one. Each
+    // trial keeps its own generator and comes out identical to Run with its seed. Trial i
+    // publishes telemetry as the thread's channel with its trial number offset by i.
+    template <typename Seed>
+    std::vector<Statistics> RunLockStep(std::span<const Seed> seeds)
+    {
+        Arena& arena = ThreadArena();
+        arena.Reset();
+
+        std::vector<Trial> trials;
+        trials.reserve(seeds.size());
+        for (int i = 0; i < seeds.size(); i++)
+        {
+            TelemetryChannel telemetry = ThreadTelemetry();
+            telemetry.trial += i;
+            trials.push_back(StartTrial(seeds[i], arena, std::move(telemetry)));
+        }
+
+        std::vector<Trial*> running;
+        for (Trial& trial : trials)
+            running.push_back(&trial);
+        std::vector<Member*> pending;
+        while (!running.empty())
+        {
+            pending.clear();
+            for (Trial* trial : running)
+                for (Member& individual : trial->pending)
+                    pending.push_back(&individual);
+            EvaluateAll(pending);
+
+            std::size_t kept = 0;
+            for (Trial* trial : running)
+                if (Advance(*trial)) running[kept++] = trial;
+            running.resize(kept);
+        }
+
+        // the trials shared the arena, each is charged an equal share
+        std::vector<Statistics> results;
+        for (Trial& trial : trials)
+        {
+            trial.stats.populationBytes = arena.BytesUsed() / trials.size();
+            results.push_back(std::move(trial.stats));
+        }
+        return results;
+    }
+
+private:
+    // One run between generations. pending is the part of the newest generation still to be
+    // evaluated, Advance takes it from there once it has been.
+    struct Trial
+    {
+        Statistics stats;
+        Rng generator;
+        TelemetryChannel telemetry;
+        Pop population;
+        Pop newGeneration;
+        Pop spare;    // the dropped child of the last pair, with an odd number of elites
+        Pop climber;  // Baldwinian scratch
+        ArenaArray<int> order;
+        ArenaArray<float> reduceScratch;
+        ArenaArray<uint64_t> packedRows;
+        std::span<Member> pending;
+        int generation = 0;  // of pending
+
+        // the operator rates, and the pending children's fitter parent and whether it was
+        // crossed, which AdaptRates judges them by
+        double mutationRate = 0.0;
+        double crossoverRate = 0.0;
+        ArenaArray<float> parentFitnesses;
+        ArenaArray<uint8_t> crossed;
+
+        int fittestIndex = 0;
+        float bestFitness = 0.0f;
+        int lastImprovement = 0;
+    };
+
+    // Chromosomes that hold an allocator (SpecChromosome) keep their buffers in the arena.
+    static Member MakeMember(Arena& arena)
+    {
+        if constexpr (std::uses_allocator_v<GenomeType, std::pmr::polymorphic_allocator<std::byte>>)
+            return Member{GenomeType(&arena), 0.0f, 0.0f};
+        else
+            return Member{};
+    }
+
+    // Allocates a trial and initializes its population, which is left pending.
+    Trial StartTrial(typename Rng::result_type seed, Arena& arena, TelemetryChannel telemetry)
+    {
+        Trial trial;
+        trial.stats.seed = seed;
+        ResizeStatistics(trial.stats, config_.generations);
+        trial.generator.seed(seed);
+        trial.telemetry = std::move(telemetry);
+
+        const int size = config_.populationSize;
+        trial.population = Pop(arena, size, [&] { return MakeMember(arena); });
+        trial.newGeneration = Pop(arena, size, [&] { return MakeMember(arena); });
+        trial.spare = Pop(arena, 1, [&] { return MakeMember(arena); });
+        trial.climber = Pop(arena, 1, [&] { return MakeMember(arena); });
+
+        // scratch for ranking the population, for elitism and the memetic stage
+        const bool ranked =
+            config_.elitismCount > 0 || config_.localSearch != LocalSearchMode::NONE;
+        trial.order = ArenaArray<int>(arena, ranked ? size : 0, [] { return 0; });
+        trial.reduceScratch = ArenaArray<float>(arena, 2 * size, [] { return 0.0f; });
+
+        trial.mutationRate = mutationProb_;
+        trial.crossoverRate = crossoverProb_;
+        trial.stats.mutationRates[0] = static_cast<float>(mutationProb_);
+        trial.stats.crossoverRates[0] = static_cast<float>(crossoverProb_);
+        if (config_.adaptiveRates)
+        {
+            trial.parentFitnesses = ArenaArray<float>(arena, size, [] { return 0.0f; });
+            trial.crossed = ArenaArray<uint8_t>(arena, size, [] { return uint8_t{0}; });
+        }
+
+        trial.telemetry.Start();
+
+        // a genome can initialize the whole population at once, e.g. to stratify it
+        if constexpr (requires(std::span<Member> members) {
+                          genome_.InitializePopulation(trial.generator, members);
+                      })
+            genome_.InitializePopulation(trial.generator, std::span<Member>(trial.population));
+        else
+            for (Member& individual : trial.population)
+                genome_.Initialize(trial.generator, individual);
+
+        // one row of packed room words per individual, only needed for the diversity stats
+        if (config_.diversityStats)
+        {
+            const std::size_t words =
+                genome_.ToPackedRooms(trial.population[0].chromosome).size();
+            trial.packedRows =
+                ArenaArray<uint64_t>(arena, size * words, [] { return uint64_t{0}; });
+            trial.stats.diversity.resize(config_.generations + 1);
+        }
+
+        trial.pending = std::span<Member>(trial.population);
+        return trial;
+    }
+
+    // Finishes the generation in trial.pending now that it has been evaluated, then breeds
+    // the next one into pending. Returns false once the trial has stopped.
+    bool Advance(Trial& trial)
+    {
+        Statistics& stats = trial.stats;
+        const int size = config_.populationSize;
+        const int gen = trial.generation;
+
+        // every child slot of pending, the child dropped from an odd last pair isn't evaluated
+        const int evaluationsPerGeneration = size - config_.elitismCount;
+
+        if (gen == 0)
+        {
+            const int64_t climbs = Refine(trial.population, 0, trial.order, trial.climber[0]);
+            stats.evaluations[0] = size;
+            stats.localSearchEvaluations[0] = climbs;
+
+            trial.fittestIndex =
+                RecordGeneration(stats, 0, genome_, trial.population, trial.reduceScratch);
+            if (config_.diversityStats)
+                RecordDiversity(stats, trial.population, 0, trial.packedRows);
+            trial.telemetry.Publish(0, config_.generations, stats.maxFitnesses[0],
+                                    stats.avgFitnesses[0], size + climbs);
+            trial.bestFitness = stats.maxFitnesses[0];
+        }
+        else
+        {
+            // judged before the memetic stage improves on the children
+            if (config_.adaptiveRates) AdaptRates(trial);
+
+            // the elites were refined (or beat every refined individual) last generation
+            const int64_t climbs =
+                Refine(trial.newGeneration, config_.elitismCount, trial.order, trial.climber[0]);
+            stats.evaluations[gen] = stats.evaluations[gen - 1] + evaluationsPerGeneration;
+            stats.localSearchEvaluations[gen] = stats.localSearchEvaluations[gen - 1] + climbs;
+
+            trial.fittestIndex =
+                RecordGeneration(stats, gen, genome_, trial.newGeneration, trial.reduceScratch);
+            if (config_.diversityStats)
+                RecordDiversity(stats, trial.newGeneration, gen, trial.packedRows);
+            trial.telemetry.Publish(gen, config_.generations, stats.maxFitnesses[gen],
+                                    stats.avgFitnesses[gen], evaluationsPerGeneration + climbs);
+            std::swap(trial.population, trial.newGeneration);
+
+            if (stats.maxFitnesses[gen] > trial.bestFitness)
+            {
+                trial.bestFitness = stats.maxFitnesses[gen];
+                trial.lastImprovement = gen;
+            }
+        }
+
+        if (gen == config_.generations) return false;
+
+        const StopReason reason =
+            CheckStopCriteria(config_, stats, gen, trial.lastImprovement, [&] {
+                return PopulationDiversity(genome_, trial.population, trial.fittestIndex);
+            });
+        if (reason != StopReason::GENERATION_LIMIT)
+        {
+            FreezeStatistics(stats, gen, reason);
+            return false;
+        }
+
+        Breed(trial);
+        trial.pending = std::span<Member>(trial.newGeneration).subspan(config_.elitismCount);
+        trial.generation = gen + 1;
+        stats.mutationRates[gen + 1] = static_cast<float>(trial.mutationRate);
+        stats.crossoverRates[gen + 1] = static_cast<float>(trial.crossoverRate);
+        return true;
+    }
+
+    // Fills the trial's new generation, leaving the offspring unevaluated.
+    void Breed(Trial& trial)
+    {
+        const Pop& population = trial.population;
+        Pop& newGeneration = trial.newGeneration;
+        const int size = config_.populationSize;
+
+        // the policies are shared by every trial of a lock-step run, each breeds at its rates
+        if (config_.adaptiveRates)
+        {
+            if constexpr (RatedPolicy<Mutation>) mutation_.probability = trial.mutationRate;
+            if constexpr (RatedPolicy<Crossover>) crossover_.probability = trial.crossoverRate;
+        }
+
+        selection_.Prepare(population);
+
+        // the elites occupy the front of the new generation, offspring fill the rest
+        CopyElites(population, newGeneration, trial.order, config_.elitismCount);
+
+        for (int i = config_.elitismCount; i < size; i += 2)
+        {
+            const Member& parent0 = population[selection_.Pick(trial.generator, population)];
+            const Member& parent1 = population[selection_.Pick(trial.generator, population)];
+
+            // mutation occurs within the crossover policy. With an odd number of elites, the
+            // last pair only has room for one child.
+            Member& child1 = i + 1 < size ? newGeneration[i + 1] : trial.spare[0];
+            const bool crossed = crossover_(trial.generator, mutation_, parent0.chromosome,
+                                            parent1.chromosome, newGeneration[i].chromosome,
+                                            child1.chromosome);
+
+            if (!config_.adaptiveRates) continue;
+            for (int c = i; c < std::min(i + 2, size); c++)
+            {
+                trial.parentFitnesses[c] = std::max(parent0.fitness, parent1.fitness);
+                trial.crossed[c] = crossed;
+            }
+        }
+    }
+
+    // Success-based rates for the next generation, from the children just evaluated. The
+    // mutation rate follows the 1/5 rule: it grows while more than a fifth of the children
+    // beat both their parents and shrinks otherwise. The crossover rate moves towards
+    // whichever of crossed and uncrossed children succeeded more often.
+    void AdaptRates(Trial& trial) const
+    {
+        int children[2] = {};
+        int successes[2] = {};
+        for (int i = config_.elitismCount; i < config_.populationSize; i++)
+        {
+            const int crossed = trial.crossed[i];
+            children[crossed]++;
+            successes[crossed] += trial.newGeneration[i].fitness > trial.parentFitnesses[i];
+        }
+        if (children[0] + children[1] == 0) return;
+
+        const double successRate =
+            static_cast<double>(successes[0] + successes[1]) / (children[0] + children[1]);
+        trial.mutationRate = std::clamp(successRate > TARGET_SUCCESS_RATE
+                                            ? trial.mutationRate * MUTATION_RATE_FACTOR
+                                            : trial.mutationRate / MUTATION_RATE_FACTOR,
+                                        MIN_ADAPTIVE_MUTATION_PROB, MAX_ADAPTIVE_MUTATION_PROB);
+
+        if (children[0] == 0 || children[1] == 0) return;
+        const double uncrossedRate = static_cast<double>(successes[0]) / children[0];
+        const double crossedRate = static_cast<double>(successes[1]) / children[1];
+        if (crossedRate != uncrossedRate)
+            trial.crossoverRate = std::clamp(
+                trial.crossoverRate +
+                    (crossedRate > uncrossedRate ? CROSSOVER_RATE_STEP : -CROSSOVER_RATE_STEP),
+                MIN_ADAPTIVE_CROSSOVER_PROB, MAX_ADAPTIVE_CROSSOVER_PROB);
+    }
+
+    void Evaluate(Member& individual) const
+    {
+        EvaluationResult result = evaluator_(individual.chromosome);
+        individual.objective = result.objective;
+        individual.fitness = result.fitness;
+    }
+
+    // Evaluates the individuals of several trials at once, in a single batch if the evaluator
+    // has one (SpecEvaluator::EvaluateBatch).
+    void EvaluateAll(std::span<Member* const> individuals) const
+    {
+        if constexpr (requires(std::span<GenomeType* const> chromosomes,
+                               std::span<EvaluationResult> results) {
+                          evaluator_.EvaluateBatch(chromosomes, results);
+                      })
+        {
+            thread_local std::vector<GenomeType*> chromosomes;
+            thread_local std::vector<EvaluationResult> results;
+            chromosomes.clear();
+            for (Member* individual : individuals)
+                chromosomes.push_back(&individual->chromosome);
+            results.resize(individuals.size());
+
+            evaluator_.EvaluateBatch(std::span<GenomeType* const>(chromosomes),
+                                     std::span<EvaluationResult>(results));
+            for (std::size_t i = 0; i < individuals.size(); i++)
+            {
+                individuals[i]->objective = results[i].objective;
+                individuals[i]->fitness = results[i].fitness;
+            }
+        }
+        else
+            for (Member* individual : individuals)
+                Evaluate(*individual);
+    }
+
+    void RecordDiversity(Statistics& stats, const Pop& population, int gen,
+                         ArenaArray<uint64_t>& rows) const
+    {
+        const std::size_t words = rows.size() / population.size();
+        for (int i = 0; i < population.size(); i++)
+        {
+            const GenomeType& chromosome = population[i].chromosome;
+            if constexpr (requires(std::span<uint64_t> out) { genome_.PackRooms(chromosome, out); })
+            {
+                genome_.PackRooms(chromosome, std::span<uint64_t>(rows.begin() + i * words, words));
+            }
+            else
+            {
+                const std::vector<uint64_t> rooms = genome_.ToPackedRooms(chromosome);
+                std::copy(rooms.begin(), rooms.end(), rows.begin() + i * words);
+            }
+        }
+
+        const std::span<const uint64_t> packed(rows.begin(), rows.size());
+        stats.diversity[gen] = MeasureDiversity(packed, static_cast<int>(population.size()));
+    }
+
+    // Puts the indices of the count fittest individuals from first onwards at the front of
+    // indices, fittest first.
+    static void RankFittest(const Pop& population, int first, ArenaArray<int>& indices,
+                            int count)
+    {
+        const int candidates = static_cast<int>(population.size()) - first;
+        for (int i = 0; i < candidates; i++)
+            indices[i] = first + i;
+
+        std::partial_sort(
+            indices.begin(), indices.begin() + count, indices.begin() + candidates,
+            [&](int a, int b) { return population[a].fitness > population[b].fitness; });
+    }
+
+    static void CopyElites(const Pop& population, Pop& newGeneration, ArenaArray<int>& indices,
+                           int count)
+    {
+        if (count <= 0) return;
+
+        RankFittest(population, 0, indices, count);
+        for (int i = 0; i < count; i++)
+            newGeneration[i] = population[indices[i]];
+    }
+
+    // The memetic stage: hill climbs the localSearchTopK fittest individuals from first
+    // onwards. Returns the number of evaluations it spent.
+    int64_t Refine(Pop& population, int first, ArenaArray<int>& indices, Member& climber) const
+    {
+        if constexpr (ClimbableGenome<Genome>)
+        {
+            const int count =
+                std::min(config_.localSearchTopK, static_cast<int>(population.size()) - first);
+            if (config_.localSearch == LocalSearchMode::NONE || count <= 0) return 0;
+
+            RankFittest(population, first, indices, count);
+
+            int64_t evaluations = 0;
+            for (int i = 0; i < count; i++)
+            {
+                Member& x = population[indices[i]];
+                if (config_.localSearch == LocalSearchMode::LAMARCKIAN)
+                {
+                    evaluations += HillClimb(genome_, evaluator_, x, config_.localSearchBudget);
+                    continue;
+                }
+
+                // Baldwinian: climb a copy, only the fitness it reached is kept
+                climber.chromosome = x.chromosome;
+                climber.objective = x.objective;
+                climber.fitness = x.fitness;
+                evaluations +=
+                    HillClimb(genome_, evaluator_, climber, config_.localSearchBudget);
+                x.objective = climber.objective;
+                x.fitness = climber.fitness;
+            }
+            return evaluations;
+        }
+        else
+            return 0;
+    }
+
+    GAConfig config_;
+    Genome genome_;
+    Selection selection_;
+    Crossover crossover_;
+    Mutation mutation_;
+    Evaluator evaluator_;
+
+    // the rates the policies came with, every trial starts from these
+    double mutationProb_ = 0.0;
+    double crossoverProb_ = 0.0;
+};
+
+// The original GA: bitstring genome, single-point crossover with bit-flip mutation,
+// evaluated by decoding the full RoomSet. Only the selection scheme and gene encoding vary.
+template <typename Selection, GeneEncoding Encoding = GeneEncoding::BINARY>
+using DefaultGeneticAlgorithm =
+    GeneticAlgorithm<BitstringGenome<Encoding>, Selection, SinglePointCrossover, BitFlipMutation,
+                     RoomSetEvaluator<Encoding>>;
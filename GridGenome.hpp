@@ -0,0 +1,202 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "GeneticAlgorithm.hpp"
+#include "Rooms.hpp"
+#include "encoding.hpp"
+
+// An alternative genome that stores each room's length and width directly as
+// integer grid codes (tenths of a unit), i.e. the value a 10-bit gene would decode to.
+// Evaluation reads the codes directly, so there is no DecodeChromosome step.
+// The vestigial x and y genes are not stored at all.
+
+constexpr int GRID_GENES_PER_ROOM = 2;
+constexpr int GRID_GENES = NUM_ROOMS * GRID_GENES_PER_ROOM;
+
+// length and width of room i live at indices 2i and 2i + 1
+using GridChromosome = std::array<int16_t, GRID_GENES>;
+
+constexpr int16_t ToGridCode(float value)
+{
+    return static_cast<int16_t>(value * 10.0f + 0.5f);
+}
+
+// Bounds of each gene, taken from the room constraints.
+// Mutation and crossover never leave these bounds.
+struct GridBounds
+{
+    int16_t low;
+    int16_t high;
+};
+
+constexpr std::array<GridBounds, GRID_GENES> GRID_BOUNDS = {{
+    {ToGridCode(LIVING_LENGTH.low), ToGridCode(LIVING_LENGTH.high)},
+    {ToGridCode(LIVING_WIDTH.low), ToGridCode(LIVING_WIDTH.high)},
+    {ToGridCode(KITCHEN_LENGTH.low), ToGridCode(KITCHEN_LENGTH.high)},
+    {ToGridCode(KITCHEN_WIDTH.low), ToGridCode(KITCHEN_WIDTH.high)},
+    {ToGridCode(BATH_LENGTH), ToGridCode(BATH_LENGTH)},
+    {ToGridCode(BATH_WIDTH), ToGridCode(BATH_WIDTH)},
+    {ToGridCode(HALL_LENGTH), ToGridCode(HALL_LENGTH)},
+    {ToGridCode(HALL_WIDTH.low), ToGridCode(HALL_WIDTH.high)},
+    {ToGridCode(BED1_LENGTH.low), ToGridCode(BED1_LENGTH.high)},
+    {ToGridCode(BED1_WIDTH.low), ToGridCode(BED1_WIDTH.high)},
+    {ToGridCode(BED2_LENGTH.low), ToGridCode(BED2_LENGTH.high)},
+    {ToGridCode(BED2_WIDTH.low), ToGridCode(BED2_WIDTH.high)},
+    {ToGridCode(BED3_LENGTH.low), ToGridCode(BED3_LENGTH.high)},
+    {ToGridCode(BED3_WIDTH.low), ToGridCode(BED3_WIDTH.high)},
+}};
+
+inline int16_t ClampToGrid(double value, int gene)
+{
+    const double rounded = std::round(value);
+    return static_cast<int16_t>(
+        std::clamp(rounded, static_cast<double>(GRID_BOUNDS[gene].low),
+                   static_cast<double>(GRID_BOUNDS[gene].high)));
+}
+
+// Same room values as the bitstring decoder would produce for these codes.
+inline float GridCodeToFloat(int16_t code)
+{
+    return static_cast<float>(code * 0.1);
+}
+
+inline RoomSet GridToRoomSet(const GridChromosome& chromosome)
+{
+    static constexpr std::array<RoomType, NUM_ROOMS> roomTypes = {
+        RoomType::LIVING, RoomType::KITCHEN, RoomType::BATH, RoomType::HALL,
+        RoomType::BED1,   RoomType::BED2,    RoomType::BED3};
+
+    RoomSet ret;
+    for (int i = 0; i < NUM_ROOMS; i++)
+    {
+        ret[i].length = GridCodeToFloat(chromosome[i * GRID_GENES_PER_ROOM]);
+        ret[i].width = GridCodeToFloat(chromosome[i * GRID_GENES_PER_ROOM + 1]);
+        ret[i].x = 0.0f;
+        ret[i].y = 0.0f;
+        ret[i].type = roomTypes[i];
+    }
+    return ret;
+}
+
+struct GridGenome
+{
+    using Chromosome = GridChromosome;
+
+    template <typename Rng>
+    static void Initialize(Rng& generator, BasicIndividual<Chromosome>& x)
+    {
+        RoomSet roomSet = InitializeRoomSet(generator);
+        for (int i = 0; i < NUM_ROOMS; i++)
+        {
+            x.chromosome[i * GRID_GENES_PER_ROOM] = ToGridCode(roomSet[i].length);
+            x.chromosome[i * GRID_GENES_PER_ROOM + 1] = ToGridCode(roomSet[i].width);
+        }
+    }
+
+    static constexpr int Length() { return GRID_GENES; }
+
+    // number of differing genes
+    static int Distance(const Chromosome& a, const Chromosome& b)
+    {
+        int differingGenes = 0;
+        for (int i = 0; i < GRID_GENES; i++)
+            differingGenes += a[i] != b[i];
+        return differingGenes;
+    }
+
+    static std::vector<uint64_t> ToPackedRooms(const Chromosome& chromosome)
+    {
+        return PackedRooms(PackChromosome(EncodeChromosome(GridToRoomSet(chromosome))));
+    }
+};
+
+// Bounded Gaussian mutation: each gene is perturbed by N(0, sigma) grid steps with the given
+// probability, then rounded back onto the grid and clamped to the gene's bounds.
+struct GaussianMutation
+{
+    double probability = 0.01;
+    double sigma = 2.0;
+
+    template <typename Rng>
+    int16_t operator()(Rng& generator, int16_t code, int gene) const
+    {
+        std::uniform_real_distribution<double> dist(0.0, 1.0);
+        if (dist(generator) > probability) return code;
+
+        std::normal_distribution<double> step(0.0, sigma);
+        return ClampToGrid(code + step(generator), gene);
+    }
+};
+
+// Simulated binary crossover (SBX). Each room is recombined with probability 0.5,
+// spreading the children around the parents with a polynomial distribution
+// controlled by the distribution index. The length and width of a room share one spread
+// factor, so two parents with the same proportion produce children with that proportion.
+// As in the usual SBX implementations, the two children swap the room half of the time,
+// which lets whole rooms move between lineages like uniform crossover.
+struct SimulatedBinaryCrossover
+{
+    double probability = CROSSOVER_PROB;
+    double distributionIndex = 20.0;
+
+    template <typename Rng, typename Mutation>
+    bool operator()(Rng& generator, const Mutation& mutate, const GridChromosome& parent0,
+                    const GridChromosome& parent1, GridChromosome& child0,
+                    GridChromosome& child1) const
+    {
+        std::uniform_real_distribution<double> dist(0.0, 1.0);
+
+        child0 = parent0;
+        child1 = parent1;
+
+        const bool crossed = dist(generator) <= probability;
+        if (crossed)
+        {
+            const double exponent = 1.0 / (distributionIndex + 1.0);
+            for (int room = 0; room < NUM_ROOMS; room++)
+            {
+                if (dist(generator) > 0.5) continue;
+
+                const double u = dist(generator);
+                const double beta = u <= 0.5 ? std::pow(2.0 * u, exponent)
+                                             : std::pow(1.0 / (2.0 * (1.0 - u)), exponent);
+                const bool swap = dist(generator) <= 0.5;
+
+                for (int j = 0; j < GRID_GENES_PER_ROOM; j++)
+                {
+                    const int i = room * GRID_GENES_PER_ROOM + j;
+                    const double mean = 0.5 * (parent0[i] + parent1[i]);
+                    const double halfSpread = 0.5 * beta * (parent1[i] - parent0[i]);
+                    child0[i] = ClampToGrid(swap ? mean + halfSpread : mean - halfSpread, i);
+                    child1[i] = ClampToGrid(swap ? mean - halfSpread : mean + halfSpread, i);
+                }
+            }
+        }
+
+        for (int i = 0; i < GRID_GENES; i++)
+        {
+            child0[i] = mutate(generator, child0[i], i);
+            child1[i] = mutate(generator, child1[i], i);
+        }
+        return crossed;
+    }
+};
+
+// Evaluates the grid codes directly, no bit decoding involved.
+struct GridEvaluator
+{
+    EvaluationResult operator()(const GridChromosome& chromosome) const
+    {
+        return EvaluateIndividual(GridToRoomSet(chromosome));
+    }
+};
+
+template <typename Selection>
+using GridGeneticAlgorithm = GeneticAlgorithm<GridGenome, Selection, SimulatedBinaryCrossover,
+                                              GaussianMutation, GridEvaluator>;
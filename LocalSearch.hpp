@@ -0,0 +1,71 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+
+#include "encoding.hpp"
+
+// Memetic local search over the packed room word genomes.
+// Bit-flip mutation rarely produces the exact +-0.1 steps that a fixed proportion room needs,
+// so the engine can hill climb its fittest individuals on the (length, width) grid instead.
+// A genome policy supports this if it can read and write a chromosome's room words and
+// convert them to and from plain binary (see SpecGenome.hpp).
+
+template <typename Genome>
+concept ClimbableGenome = requires(const Genome& genome, typename Genome::Chromosome& chromosome,
+                                   uint64_t word) {
+    { genome.ToBinaryWord(word) } -> std::same_as<uint64_t>;
+    { genome.FromBinaryWord(word) } -> std::same_as<uint64_t>;
+    { genome.RoomWord(chromosome, 0) } -> std::same_as<uint64_t>;
+    genome.SetRoomWord(chromosome, 0, word);
+};
+
+// First-improvement hill climb over the 8 grid neighbours (length and/or width +-0.1) of
+// every room. Stops at a local optimum or after maxEvaluations evaluations, and returns the
+// number of evaluations it spent. x.objective and x.fitness must be up to date.
+// Rejected moves are undone by writing the old word back, with the incremental evaluators
+// that only costs re-checking that one room on the next evaluation.
+template <ClimbableGenome Genome, typename Evaluator, typename Member>
+int HillClimb(const Genome& genome, const Evaluator& evaluator, Member& x, int maxEvaluations)
+{
+    constexpr uint64_t SIZE_MASK = (GENE_MASK << (3 * FLOAT_BITWIDTH)) |
+                                   (GENE_MASK << (2 * FLOAT_BITWIDTH));
+
+    int evaluations = 0;
+    for (bool improved = true; improved;)
+    {
+        improved = false;
+        for (int r = 0; r < genome.Length() / ROOM_BITWIDTH; r++)
+        {
+            for (int move = 0; move < 9; move++)
+            {
+                const int dLength = move / 3 - 1;
+                const int dWidth = move % 3 - 1;
+                if (dLength == 0 && dWidth == 0) continue;
+                if (evaluations >= maxEvaluations) return evaluations;
+
+                const uint64_t original = genome.RoomWord(x.chromosome, r);
+                const uint64_t binary = genome.ToBinaryWord(original);
+                const int32_t length = PackedRoomLength(binary) + dLength;
+                const int32_t width = PackedRoomWidth(binary) + dWidth;
+                if (length < 0 || length > GENE_MASK || width < 0 || width > GENE_MASK) continue;
+
+                const uint64_t neighbour =
+                    (binary & ~SIZE_MASK) | (PackRoomWord(length, width, 0, 0) & SIZE_MASK);
+                genome.SetRoomWord(x.chromosome, r, genome.FromBinaryWord(neighbour));
+                const auto result = evaluator(x.chromosome);
+                evaluations++;
+
+                if (result.fitness > x.fitness)
+                {
+                    x.objective = result.objective;
+                    x.fitness = result.fitness;
+                    improved = true;
+                }
+                else
+                    genome.SetRoomWord(x.chromosome, r, original);
+            }
+        }
+    }
+    return evaluations;
+}
@@ -0,0 +1,358 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "Arena.hpp"
+#include "GeneticAlgorithm.hpp"
+#include "GridGenome.hpp"
+#include "Telemetry.hpp"
+
+// Search algorithms other than the GA, behind the same interface as GeneticAlgorithm:
+// construct one from a GAConfig and its evaluator, and Run(seed) returns the Statistics the
+// outputs, sweeps and plots already understand. All of them search the integer grid
+// (GridGenome), draw from a Rng seeded like the GA's, and count evaluations the same way,
+// so evaluations to a target fitness and wall time compare directly across algorithms.
+// GAConfig::optimizer picks one, the GA-only settings (selection, crossover, elitism, local
+// search, adaptive rates) don't apply to them.
+
+template <typename Optimizer>
+concept StatisticsOptimizer = requires(Optimizer optimizer, std::mt19937::result_type seed) {
+    { optimizer.Run(seed) } -> std::same_as<Statistics>;
+};
+
+constexpr double SA_FINAL_TEMPERATURE_RATIO = 1e-3;  // of GAConfig::saTemperature
+constexpr double ES_MIN_SIGMA = 0.5;  // grid steps, any smaller and rounding undoes the step
+
+// The genes a search can move, the bath and the hall length are fixed.
+inline std::vector<int> FreeGridGenes()
+{
+    std::vector<int> genes;
+    for (int i = 0; i < GRID_GENES; i++)
+        if (GRID_BOUNDS[i].low < GRID_BOUNDS[i].high) genes.push_back(i);
+    return genes;
+}
+
+// The generation loop the backends share, with the GA's bookkeeping and stopping criteria.
+// Generation 0 is the population as initialized, which took initialEvaluations. After that
+// step(gen) must produce generation gen in population and return the evaluations it spent.
+template <typename Genome, typename Population, typename Step>
+void RunGenerations(const GAConfig& config, Statistics& stats, const Genome& genome,
+                    const Population& population, int64_t initialEvaluations,
+                    ArenaArray<float>& scratch, Step step)
+{
+    TelemetryChannel& telemetry = ThreadTelemetry();
+
+    stats.evaluations[0] = initialEvaluations;
+    int fittestIndex = RecordGeneration(stats, 0, genome, population, scratch);
+    telemetry.Publish(0, config.generations, stats.maxFitnesses[0], stats.avgFitnesses[0],
+                      static_cast<int>(initialEvaluations));
+
+    float bestFitness = stats.maxFitnesses[0];
+    int lastImprovement = 0;
+    for (int gen = 0; gen < config.generations; gen++)
+    {
+        const StopReason reason = CheckStopCriteria(config, stats, gen, lastImprovement, [&] {
+            return PopulationDiversity(genome, population, fittestIndex);
+        });
+        if (reason != StopReason::GENERATION_LIMIT)
+        {
+            FreezeStatistics(stats, gen, reason);
+            return;
+        }
+
+        const int64_t evaluations = step(gen + 1);
+        stats.evaluations[gen + 1] = stats.evaluations[gen] + evaluations;
+        fittestIndex = RecordGeneration(stats, gen + 1, genome, population, scratch);
+        telemetry.Publish(gen + 1, config.generations, stats.maxFitnesses[gen + 1],
+                          stats.avgFitnesses[gen + 1], static_cast<int>(evaluations));
+
+        if (stats.maxFitnesses[gen + 1] > bestFitness)
+        {
+            bestFitness = stats.maxFitnesses[gen + 1];
+            lastImprovement = gen + 1;
+        }
+    }
+}
+
+// Evaluates one member of a backend's population in place.
+template <typename Evaluator, typename Member>
+void EvaluateMember(const Evaluator& evaluator, Member& individual)
+{
+    const EvaluationResult result = evaluator(individual.chromosome);
+    individual.objective = result.objective;
+    individual.fitness = result.fitness;
+}
+
+// Differential evolution, DE/rand/1/bin: every generation each individual is challenged by
+// a trial built from three others, a + F (b - c) on each gene crossed in with probability
+// CR (and on one gene always), rounded back onto the grid. The trial replaces it if it is
+// at least as fit.
+template <typename Evaluator = GridEvaluator, typename Rng = std::mt19937>
+class DifferentialEvolution
+{
+public:
+    using Member = BasicIndividual<GridChromosome>;
+    using Pop = BasicPopulation<GridChromosome>;
+
+    explicit DifferentialEvolution(const GAConfig& config, Evaluator evaluator = {})
+        : config_(config),
+          evaluator_(evaluator)
+    {
+    }
+
+    Statistics Run(typename Rng::result_type seed)
+    {
+        Statistics stats;
+        stats.seed = seed;
+        ResizeStatistics(stats, config_.generations);
+        Rng generator{seed};
+
+        Arena& arena = ThreadArena();
+        arena.Reset();
+
+        const int size = config_.populationSize;
+        Pop population(arena, size, [] { return Member{}; });
+        Pop trials(arena, size, [] { return Member{}; });
+        ArenaArray<float> scratch(arena, 2 * size, [] { return 0.0f; });
+
+        ThreadTelemetry().Start();
+        for (Member& individual : population)
+        {
+            genome_.Initialize(generator, individual);
+            EvaluateMember(evaluator_, individual);
+        }
+
+        std::uniform_int_distribution<int> pick(0, size - 1);
+        // the forced gene must be one DE can move, or the trial may copy its target
+        const std::vector<int> genes = FreeGridGenes();
+        std::uniform_int_distribution<int> geneDist(0, static_cast<int>(genes.size()) - 1);
+        std::uniform_real_distribution<double> dist(0.0, 1.0);
+        RunGenerations(config_, stats, genome_, population, size, scratch, [&](int) {
+            for (int i = 0; i < size; i++)
+            {
+                // three distinct individuals, none of them the target
+                std::array<int, 3> r;
+                for (int k = 0; k < 3; k++)
+                    do
+                        r[k] = pick(generator);
+                    while (r[k] == i || std::find(r.begin(), r.begin() + k, r[k]) != r.begin() + k);
+
+                const GridChromosome& a = population[r[0]].chromosome;
+                const GridChromosome& b = population[r[1]].chromosome;
+                const GridChromosome& c = population[r[2]].chromosome;
+                const int forced = genes[geneDist(generator)];
+                for (int j = 0; j < GRID_GENES; j++)
+                    trials[i].chromosome[j] =
+                        j == forced || dist(generator) < config_.deCrossoverProb
+                            ? ClampToGrid(a[j] + config_.deWeight * (b[j] - c[j]), j)
+                            : population[i].chromosome[j];
+                EvaluateMember(evaluator_, trials[i]);
+            }
+
+            for (int i = 0; i < size; i++)
+                if (trials[i].fitness >= population[i].fitness) population[i] = trials[i];
+            return int64_t{size};
+        });
+
+        stats.populationBytes = arena.BytesUsed();
+        return stats;
+    }
+
+private:
+    GAConfig config_;
+    GridGenome genome_;
+    Evaluator evaluator_;
+};
+
+// Simulated annealing on one chain. It starts from the fittest of populationSize random
+// layouts (generation 0), then each move shifts one free gene by N(0, gridMutationSigma)
+// grid steps (at least one) and the other gene of its room by N(0, gridMutationSigma), and
+// is accepted by the Metropolis rule on fitness. The temperature cools geometrically from
+// saTemperature to a thousandth of it by the generation limit. A generation is
+// populationSize moves, and its statistics are over the states the chain held after each.
+template <typename Evaluator = GridEvaluator, typename Rng = std::mt19937>
+class SimulatedAnnealing
+{
+public:
+    using Member = BasicIndividual<GridChromosome>;
+    using Pop = BasicPopulation<GridChromosome>;
+
+    explicit SimulatedAnnealing(const GAConfig& config, Evaluator evaluator = {})
+        : config_(config),
+          evaluator_(evaluator)
+    {
+    }
+
+    Statistics Run(typename Rng::result_type seed)
+    {
+        Statistics stats;
+        stats.seed = seed;
+        ResizeStatistics(stats, config_.generations);
+        Rng generator{seed};
+
+        Arena& arena = ThreadArena();
+        arena.Reset();
+
+        const int size = config_.populationSize;
+        Pop visited(arena, size, [] { return Member{}; });
+        ArenaArray<float> scratch(arena, 2 * size, [] { return 0.0f; });
+
+        ThreadTelemetry().Start();
+        for (Member& individual : visited)
+        {
+            genome_.Initialize(generator, individual);
+            EvaluateMember(evaluator_, individual);
+        }
+        Member current = *std::max_element(
+            visited.begin(), visited.end(),
+            [](const Member& a, const Member& b) { return a.fitness < b.fitness; });
+        Member candidate = current;
+
+        const std::vector<int> genes = FreeGridGenes();
+        std::uniform_int_distribution<int> geneDist(0, static_cast<int>(genes.size()) - 1);
+        std::normal_distribution<double> stepDist(0.0, config_.gridMutationSigma);
+        std::uniform_real_distribution<double> dist(0.0, 1.0);
+        const double moves = static_cast<double>(config_.generations) * size;
+        const double cooling = std::pow(SA_FINAL_TEMPERATURE_RATIO, 1.0 / moves);
+        double temperature = config_.saTemperature;
+
+        RunGenerations(config_, stats, genome_, visited, size, scratch, [&](int) {
+            for (int i = 0; i < size; i++)
+            {
+                const int gene = genes[geneDist(generator)];
+                double step = std::round(stepDist(generator));
+                if (step == 0.0) step = dist(generator) < 0.5 ? -1.0 : 1.0;
+
+                candidate.chromosome = current.chromosome;
+                candidate.chromosome[gene] = ClampToGrid(current.chromosome[gene] + step, gene);
+
+                // the rest of the room moves too, or the proportion checks reject most moves
+                static_assert(GRID_GENES_PER_ROOM == 2);
+                const int other = gene ^ 1;
+                if (GRID_BOUNDS[other].low < GRID_BOUNDS[other].high)
+                    candidate.chromosome[other] = ClampToGrid(
+                        current.chromosome[other] + std::round(stepDist(generator)), other);
+                EvaluateMember(evaluator_, candidate);
+
+                const double delta = candidate.fitness - current.fitness;
+                if (delta >= 0.0 || dist(generator) < std::exp(delta / temperature))
+                    current = candidate;
+                visited[i] = current;
+                temperature *= cooling;
+            }
+            return int64_t{size};
+        });
+
+        stats.populationBytes = arena.BytesUsed();
+        return stats;
+    }
+
+private:
+    GAConfig config_;
+    GridGenome genome_;
+    Evaluator evaluator_;
+};
+
+// A (mu + lambda) evolution strategy with self-adaptive step sizes. Each of the lambda
+// offspring copies a uniformly drawn parent, scales its parent's step size by
+// exp(tau N(0, 1)) with tau = 1 / sqrt(genes), then moves every free gene by N(0, step)
+// grid steps. The mu fittest of parents and offspring survive, parents winning ties.
+// mu is populationSize and lambda esOffspring, steps start at gridMutationSigma.
+template <typename Evaluator = GridEvaluator, typename Rng = std::mt19937>
+class EvolutionStrategy
+{
+public:
+    using Member = BasicIndividual<GridChromosome>;
+    using Pop = BasicPopulation<GridChromosome>;
+
+    explicit EvolutionStrategy(const GAConfig& config, Evaluator evaluator = {})
+        : config_(config),
+          evaluator_(evaluator)
+    {
+    }
+
+    Statistics Run(typename Rng::result_type seed)
+    {
+        Statistics stats;
+        stats.seed = seed;
+        ResizeStatistics(stats, config_.generations);
+        Rng generator{seed};
+
+        Arena& arena = ThreadArena();
+        arena.Reset();
+
+        const int mu = config_.populationSize;
+        const int lambda = config_.esOffspring;
+        const double sigma = config_.gridMutationSigma;
+        Pop population(arena, mu, [] { return Member{}; });
+        Pop offspring(arena, lambda, [] { return Member{}; });
+        Pop survivors(arena, mu, [] { return Member{}; });
+        ArenaArray<double> sigmas(arena, mu, [&] { return sigma; });
+        ArenaArray<double> offspringSigmas(arena, lambda, [&] { return sigma; });
+        ArenaArray<double> survivorSigmas(arena, mu, [&] { return sigma; });
+        ArenaArray<int> order(arena, mu + lambda, [] { return 0; });
+        ArenaArray<float> scratch(arena, 2 * mu, [] { return 0.0f; });
+
+        ThreadTelemetry().Start();
+        for (Member& individual : population)
+        {
+            genome_.Initialize(generator, individual);
+            EvaluateMember(evaluator_, individual);
+        }
+
+        const std::vector<int> genes = FreeGridGenes();
+        const double tau = 1.0 / std::sqrt(static_cast<double>(genes.size()));
+        std::uniform_int_distribution<int> pick(0, mu - 1);
+        std::normal_distribution<double> normal(0.0, 1.0);
+
+        // parents are 0 .. mu - 1 of the combined order, offspring mu onwards
+        auto at = [&](int i) -> const Member& {
+            return i < mu ? population[i] : offspring[i - mu];
+        };
+
+        RunGenerations(config_, stats, genome_, population, mu, scratch, [&](int) {
+            for (int k = 0; k < lambda; k++)
+            {
+                const int parent = pick(generator);
+                offspringSigmas[k] = std::max(sigmas[parent] * std::exp(tau * normal(generator)),
+                                              ES_MIN_SIGMA);
+                offspring[k].chromosome = population[parent].chromosome;
+                for (int gene : genes)
+                    offspring[k].chromosome[gene] = ClampToGrid(
+                        offspring[k].chromosome[gene] + offspringSigmas[k] * normal(generator),
+                        gene);
+                EvaluateMember(evaluator_, offspring[k]);
+            }
+
+            for (int i = 0; i < mu + lambda; i++)
+                order[i] = i;
+            std::partial_sort(order.begin(), order.begin() + mu, order.end(), [&](int a, int b) {
+                if (at(a).fitness != at(b).fitness) return at(a).fitness > at(b).fitness;
+                return a < b;
+            });
+            for (int i = 0; i < mu; i++)
+            {
+                survivors[i] = at(order[i]);
+                survivorSigmas[i] =
+                    order[i] < mu ? sigmas[order[i]] : offspringSigmas[order[i] - mu];
+            }
+            std::swap(population, survivors);
+            std::swap(sigmas, survivorSigmas);
+            return int64_t{lambda};
+        });
+
+        stats.populationBytes = arena.BytesUsed();
+        return stats;
+    }
+
+private:
+    GAConfig config_;
+    GridGenome genome_;
+    Evaluator evaluator_;
+};
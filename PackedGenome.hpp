@@ -0,0 +1,152 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "GeneticAlgorithm.hpp"
+#include "Rooms.hpp"
+#include "encoding.hpp"
+
+// Operators of the bitstring genome on packed words (one room per uint64_t, see
+// PackedChromosome).
+// Crossover builds a single mask over the chromosome and blends the parents with
+// (a & ~mask) | (b & mask) per word; mutation runs separately on the blended children.
+// The masks and operators only look at the number of room words, so they also work on
+// chromosomes whose room count is only known at runtime (see SpecGenome.hpp).
+
+inline PackedChromosome& Words(PackedChromosome& chromosome) { return chromosome; }
+inline const PackedChromosome& Words(const PackedChromosome& chromosome) { return chromosome; }
+
+inline int RoomCount(const PackedChromosome&) { return NUM_ROOMS; }
+
+// child = (a & ~mask) | (b & mask)
+inline void Blend(std::span<const uint64_t> mask, const PackedChromosome& a,
+                  const PackedChromosome& b, PackedChromosome& child)
+{
+    for (int w = 0; w < NUM_ROOMS; w++)
+        child[w] = (a[w] & ~mask[w]) | (b[w] & mask[w]);
+}
+
+// Flips chromosome bit i (in the MSB-first numbering of the unpacked chromosome).
+inline void FlipBit(PackedChromosome& chromosome, int i)
+{
+    chromosome[i / ROOM_BITWIDTH] ^= uint64_t{1} << (ROOM_BITWIDTH - 1 - i % ROOM_BITWIDTH);
+}
+
+// Toggles every mask bit with chromosome index >= index, i.e. the tail swapped by a cut at index.
+inline void XorSuffix(std::span<uint64_t> mask, int index)
+{
+    const int word = index / ROOM_BITWIDTH;
+    const int bit = index % ROOM_BITWIDTH;
+    mask[word] ^= ROOM_WORD_MASK >> bit;
+    for (int i = word + 1; i < mask.size(); i++)
+        mask[i] ^= ROOM_WORD_MASK;
+}
+
+// ===== Crossover masks =====
+
+// n cut points, each a multiple of the alignment.
+// Alignment 1 cuts anywhere, FLOAT_BITWIDTH only between genes and ROOM_BITWIDTH only
+// between rooms, so a room's length or width is never spliced mid-value.
+// A bit is taken from the other parent when an odd number of cuts lie at or before it.
+template <int Alignment>
+struct NPointMask
+{
+    int points = 1;
+
+    // mask holds one word per room and is expected to be zeroed
+    template <typename Rng>
+    void operator()(Rng& generator, std::span<uint64_t> mask) const
+    {
+        static_assert(ROOM_BITWIDTH % Alignment == 0);
+        const int cutPositions = static_cast<int>(mask.size()) * ROOM_BITWIDTH / Alignment - 1;
+        if (cutPositions < 1) return;  // a single room with room alignment can't be cut
+
+        std::uniform_int_distribution<int> dist(1, cutPositions);
+        for (int i = 0; i < points; i++)
+            XorSuffix(mask, dist(generator) * Alignment);
+    }
+};
+
+using BitNPointMask = NPointMask<1>;
+using GeneNPointMask = NPointMask<FLOAT_BITWIDTH>;
+using RoomNPointMask = NPointMask<ROOM_BITWIDTH>;
+
+// Every bit is swapped independently with probability 1/2.
+struct UniformMask
+{
+    template <typename Rng>
+    void operator()(Rng& generator, std::span<uint64_t> mask) const
+    {
+        std::uniform_int_distribution<uint64_t> dist(0, ROOM_WORD_MASK);
+        for (uint64_t& word : mask)
+            word = dist(generator);
+    }
+};
+
+// ===== Crossover =====
+
+template <typename MaskGenerator>
+struct MaskCrossover
+{
+    double probability = CROSSOVER_PROB;
+    MaskGenerator makeMask;
+    mutable std::vector<uint64_t> mask{};  // scratch space, reused across calls
+
+    // works on any chromosome with RoomCount, Blend and FlipBit overloads
+    template <typename Rng, typename Mutation, typename C>
+    bool operator()(Rng& generator, const Mutation& mutate, const C& parent0, const C& parent1,
+                    C& child0, C& child1) const
+    {
+        std::uniform_real_distribution<double> dist(0.0, 1.0);
+
+        const bool crossed = dist(generator) <= probability;
+        if (crossed)
+        {
+            mask.assign(RoomCount(parent0), 0);
+            makeMask(generator, std::span<uint64_t>(mask));
+            Blend(mask, parent0, parent1, child0);
+            Blend(mask, parent1, parent0, child1);
+        }
+        else
+        {
+            child0 = parent0;
+            child1 = parent1;
+        }
+
+        mutate(generator, child0);
+        mutate(generator, child1);
+        return crossed;
+    }
+};
+
+// ===== Mutation =====
+
+// Flips each bit independently with the given probability.
+// Rather than drawing one number per bit, the gap to the next flipped bit is drawn from
+// a geometric distribution, so the cost is proportional to the number of flips.
+struct PackedBitFlipMutation
+{
+    double probability = MUTATION_PROB;
+
+    template <typename Rng, typename C>
+    void operator()(Rng& generator, C& chromosome) const
+    {
+        const int bits = RoomCount(chromosome) * ROOM_BITWIDTH;
+        if (probability <= 0.0) return;
+        if (probability >= 1.0)
+        {
+            for (int i = 0; i < bits; i++)
+                FlipBit(chromosome, i);
+            return;
+        }
+
+        std::geometric_distribution<int> gap(probability);
+        for (int i = gap(generator); i < bits; i += gap(generator) + 1)
+            FlipBit(chromosome, i);
+    }
+};
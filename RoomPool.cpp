@@ -0,0 +1,30 @@
+#include "RoomPool.hpp"
+
+#include "Simd.hpp"
+#include "encoding.hpp"
+
+RoomPools::RoomPools(const RoomSpecTable& specs)
+{
+    // one row of widths at a time through the evaluateRooms kernel
+    const SimdKernels& kernels = Kernels();
+    std::vector<uint64_t> words;
+    std::vector<int32_t> objectives;
+    std::vector<uint8_t> fits;
+    for (const RoomSpec& spec : specs)
+    {
+        const int32_t widths = spec.width.high - spec.width.low + 1;
+        words.resize(widths);
+        objectives.resize(widths);
+        fits.resize(widths);
+        for (int32_t length = spec.length.low; length <= spec.length.high; length++)
+        {
+            for (int32_t i = 0; i < widths; i++)
+                words[i] = PackRoomWord(length, spec.width.low + i, 0, 0);
+            kernels.evaluateRooms(spec, words.data(), widths, objectives.data(), fits.data());
+            for (int32_t i = 0; i < widths; i++)
+                if (fits[i]) sizes_.push_back(PoolEntry(length, spec.width.low + i));
+        }
+        offsets_.push_back(sizes_.size());
+    }
+    sizes_.shrink_to_fit();
+}
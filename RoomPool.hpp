@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "RoomSpec.hpp"
+
+// Every valid (length, width) of each room in a spec table.
+// Rejection sampling a valid room costs a trip through DoesRoomFitSpec per attempt, for every
+// room of every individual of every trial. The valid sizes only depend on the spec table,
+// so they are enumerated once and shared read-only by every trial and thread that uses the
+// table; drawing a valid room is then a single index into its pool (see InitSampling).
+
+class RoomPools
+{
+public:
+    RoomPools() = default;
+    explicit RoomPools(const RoomSpecTable& specs);
+
+    int RoomCount() const { return static_cast<int>(offsets_.size()) - 1; }
+
+    // valid sizes of room i as PoolEntry values, ordered by length, then width
+    std::span<const uint32_t> Sizes(int room) const
+    {
+        return std::span<const uint32_t>(sizes_.data() + offsets_[room],
+                                         offsets_[room + 1] - offsets_[room]);
+    }
+
+    std::size_t TotalSizes() const { return sizes_.size(); }
+
+    static constexpr uint32_t PoolEntry(int32_t length, int32_t width)
+    {
+        return static_cast<uint32_t>(length) << 16 | static_cast<uint32_t>(width);
+    }
+    static constexpr int32_t EntryLength(uint32_t entry) { return entry >> 16; }
+    static constexpr int32_t EntryWidth(uint32_t entry) { return entry & 0xFFFF; }
+
+private:
+    // all rooms' pools back to back, room i is [offsets_[i], offsets_[i + 1])
+    std::vector<uint32_t> sizes_;
+    std::vector<std::size_t> offsets_{0};
+};
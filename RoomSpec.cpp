@@ -0,0 +1,259 @@
+#include "RoomSpec.hpp"
+
+#include <array>
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+#include "encoding.hpp"
+
+namespace
+{
+
+constexpr int32_t MAX_CODE = static_cast<int32_t>(GENE_MASK);  // 102.3 in tenths
+
+RoomSpec FixedProportionSpec(std::string name, Range<float> length, Range<float> width,
+                             Range<float> area, float proportion, int32_t costMultiplier)
+{
+    const int32_t proportionTenths = ToTenths(proportion);
+    return RoomSpec{std::move(name),
+                    ToTenths(length),
+                    ToTenths(width),
+                    ToHundredths(area),
+                    ProportionKind::FIXED,
+                    Range<int32_t>(proportionTenths, proportionTenths),
+                    costMultiplier};
+}
+
+RoomSpec RangeProportionSpec(std::string name, Range<float> length, Range<float> width,
+                             Range<float> area, Range<float> proportion, int32_t costMultiplier)
+{
+    return RoomSpec{std::move(name),       ToTenths(length),     ToTenths(width),
+                    ToHundredths(area),    ProportionKind::RANGE, ToTenths(proportion),
+                    costMultiplier};
+}
+
+// "-" leaves value untouched and returns true
+bool ParseOptional(const std::string& token, float& value)
+{
+    if (token == "-") return true;
+    std::stringstream ss(token);
+    ss >> value;
+    return !ss.fail() && ss.eof();
+}
+
+// "-" is no proportion, "p" a fixed proportion and "low-high" a proportion range
+bool ParseProportion(const std::string& token, ProportionKind& kind, float& low, float& high)
+{
+    if (token == "-")
+    {
+        kind = ProportionKind::NONE;
+        return true;
+    }
+
+    // the leading character can't be the separator, it's either a digit or a sign
+    const size_t separator = token.find('-', 1);
+    if (!ParseOptional(token.substr(0, separator), low)) return false;
+    if (separator == std::string::npos)
+    {
+        high = low;
+        kind = ProportionKind::FIXED;
+    }
+    else
+    {
+        if (!ParseOptional(token.substr(separator + 1), high)) return false;
+        kind = ProportionKind::RANGE;
+    }
+
+    return low > 0.0f && low <= high;
+}
+
+bool HasValidLayout(const RoomSpec& spec)
+{
+    for (int32_t length = spec.length.low; length <= spec.length.high; length++)
+        for (int32_t width = spec.width.low; width <= spec.width.high; width++)
+            if (DoesRoomFitSpec(spec, length, width)) return true;
+    return false;
+}
+
+}  // namespace
+
+RoomSpecTable DefaultRoomSpecs()
+{
+    // Living, Kitchen, Bath, Hall, Bed1, Bed2, Bed3, same order as ROOM_TYPES
+    RoomSpecTable specs;
+    specs.push_back(FixedProportionSpec("Living", LIVING_LENGTH, LIVING_WIDTH, LIVING_AREA,
+                                        LIVING_PROPORTION, 1));
+    specs.push_back(RangeProportionSpec("Kitchen", KITCHEN_LENGTH, KITCHEN_WIDTH, KITCHEN_AREA,
+                                        KITCHEN_PROPORTION, 2));
+
+    // the bath has a fixed size, so its area "range" is just that one area
+    const float bathArea = BATH_LENGTH * BATH_WIDTH;
+    specs.push_back(RoomSpec{"Bath", ToTenths(Range<float>(BATH_LENGTH, BATH_LENGTH)),
+                             ToTenths(Range<float>(BATH_WIDTH, BATH_WIDTH)),
+                             ToHundredths(Range<float>(bathArea, bathArea)), ProportionKind::NONE,
+                             Range<int32_t>(0, 0), 2});
+
+    specs.push_back(RangeProportionSpec("Hall", Range<float>(HALL_LENGTH, HALL_LENGTH), HALL_WIDTH,
+                                        HALL_AREA, HALL_PROPORTION, 1));
+    specs.push_back(
+        FixedProportionSpec("Bed 1", BED1_LENGTH, BED1_WIDTH, BED1_AREA, BED1_PROPORTION, 1));
+    specs.push_back(
+        FixedProportionSpec("Bed 2", BED2_LENGTH, BED2_WIDTH, BED2_AREA, BED2_PROPORTION, 1));
+    specs.push_back(
+        FixedProportionSpec("Bed 3", BED3_LENGTH, BED3_WIDTH, BED3_AREA, BED3_PROPORTION, 1));
+    return specs;
+}
+
+bool LoadRoomSpecs(const std::string& filename, RoomSpecTable& specs, std::ostream& errors)
+{
+    std::ifstream file(filename);
+    if (!file)
+    {
+        errors << "Could not open room spec file " << filename << "\n";
+        return false;
+    }
+    return ReadRoomSpecs(file, filename, specs, errors);
+}
+
+bool ReadRoomSpecs(std::istream& stream, const std::string& source, RoomSpecTable& specs,
+                   std::ostream& errors)
+{
+    RoomSpecTable loaded;
+    std::string line;
+    for (int lineNumber = 1; std::getline(stream, line); lineNumber++)
+    {
+        std::stringstream ss(line);
+        std::string name;
+        if (!(ss >> name) || name[0] == '#') continue;
+
+        std::array<std::string, 8> tokens;
+        for (std::string& token : tokens)
+            ss >> token;
+
+        float lengthLow = 0.0f, lengthHigh = 0.0f, widthLow = 0.0f, widthHigh = 0.0f;
+        std::stringstream dimensions(tokens[0] + " " + tokens[1] + " " + tokens[2] + " " +
+                                     tokens[3]);
+        dimensions >> lengthLow >> lengthHigh >> widthLow >> widthHigh;
+
+        // without area bounds, every area the length and width allow is fine
+        float areaLow = lengthLow * widthLow;
+        float areaHigh = lengthHigh * widthHigh;
+
+        int32_t costMultiplier = 0;
+        std::stringstream cost(tokens[7]);
+        cost >> costMultiplier;
+
+        ProportionKind proportionKind = ProportionKind::NONE;
+        float proportionLow = 0.0f;
+        float proportionHigh = 0.0f;
+
+        const bool parsed =
+            !ss.fail() && !dimensions.fail() && !cost.fail() && ParseOptional(tokens[4], areaLow) &&
+            ParseOptional(tokens[5], areaHigh) &&
+            ParseProportion(tokens[6], proportionKind, proportionLow, proportionHigh);
+
+        if (!parsed)
+        {
+            errors << source << ":" << lineNumber << ": malformed room spec\n";
+            return false;
+        }
+
+        const RoomSpec spec{name,
+                            ToTenths(Range<float>(lengthLow, lengthHigh)),
+                            ToTenths(Range<float>(widthLow, widthHigh)),
+                            ToHundredths(Range<float>(areaLow, areaHigh)),
+                            proportionKind,
+                            ToTenths(Range<float>(proportionLow, proportionHigh)),
+                            costMultiplier};
+
+        if (spec.length.low < 0 || spec.length.low > spec.length.high ||
+            spec.length.high > MAX_CODE || spec.width.low < 0 ||
+            spec.width.low > spec.width.high || spec.width.high > MAX_CODE ||
+            spec.area.low > spec.area.high || spec.costMultiplier < 1)
+        {
+            errors << source << ":" << lineNumber << ": room " << name
+                   << " has an empty or out of range bound (lengths must lie in [0, 102.3])\n";
+            return false;
+        }
+
+        // initialization has to be able to produce a valid room
+        if (!HasValidLayout(spec))
+        {
+            errors << source << ":" << lineNumber << ": no length and width satisfy room "
+                   << name << "\n";
+            return false;
+        }
+
+        loaded.push_back(spec);
+    }
+
+    if (loaded.empty())
+    {
+        errors << source << " contains no rooms\n";
+        return false;
+    }
+
+    specs = std::move(loaded);
+    return true;
+}
+
+SpecCostRange GetSpecCostRange(const RoomSpecTable& specs)
+{
+    SpecCostRange range{0, 0};
+    for (const RoomSpec& spec : specs)
+    {
+        range.min += int64_t{spec.costMultiplier} * spec.area.low;
+        range.max += int64_t{spec.costMultiplier} * spec.area.high;
+    }
+    return range;
+}
+
+float SpecObjectiveToFitness(const SpecCostRange& range, int64_t objectiveHundredths)
+{
+    // same C - f(x) scaling as ObjectiveToFitness, in the range [0, 100] for valid layouts
+    if (range.max == range.min) return 100.0f;
+    return static_cast<float>(range.max - objectiveHundredths) / (range.max - range.min) * 100.0f;
+}
+
+void PrintPackedRooms(const std::vector<uint64_t>& rooms, const RoomSpecTable& specs,
+                      std::ostream& stream)
+{
+    stream << "            Length     | Width      | x Pos      | y Pos      | Type\n";
+    stream << "Chromosome: ";
+    for (int i = 0; i < rooms.size(); i++)
+    {
+        std::array<char, ROOM_REPORT_LINE> line;
+        char* out = WriteRoomBits(line.data(), rooms[i]);
+        stream.write(line.data(), out - line.data());
+        stream << specs[i].name << "\n";
+
+        if (i != rooms.size() - 1) stream << "            ";
+    }
+}
+
+void PrintSpecRoomSet(const std::vector<uint64_t>& rooms, const RoomSpecTable& specs,
+                      std::ostream& stream)
+{
+    stream << "            Length     | Width      | x Pos      | y Pos      | Area         | "
+           << "PropLW     | PropWL     | Type\n";
+    stream << "RoomSet...: ";
+    for (int i = 0; i < rooms.size(); i++)
+    {
+        const int32_t lengthCode = PackedRoomLength(rooms[i]);
+        const int32_t widthCode = PackedRoomWidth(rooms[i]);
+        const ViolationMask violations = RoomSpecViolations(specs[i], lengthCode, widthCode);
+
+        const float length = static_cast<float>(lengthCode * 0.1);
+        const float width = static_cast<float>(widthCode * 0.1);
+        const float x = static_cast<float>(((rooms[i] >> FLOAT_BITWIDTH) & GENE_MASK) * 0.1);
+        const float y = static_cast<float>((rooms[i] & GENE_MASK) * 0.1);
+
+        std::array<char, ROOM_REPORT_LINE> line;
+        char* out = WriteRoomCells(line.data(), violations, length, width, x, y);
+        stream.write(line.data(), out - line.data());
+        stream << ' ' << specs[i].name << "\n";
+
+        if (i != rooms.size() - 1) stream << "            ";
+    }
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Rooms.hpp"
+
+// Data-driven room specification.
+// Each entry describes one room of the building with the fixed-point model (see ToTenths),
+// so the constraint check is the same handful of integer compares for every room
+// instead of a switch over the seven hard-coded room types.
+// A layout of N rooms is encoded as N packed room words (see PackedChromosome).
+
+enum class ProportionKind
+{
+    NONE,
+    FIXED,  // length / width or width / length equals proportion.low (within 0.01)
+    RANGE   // length / width or width / length lies within proportion
+};
+
+struct RoomSpec
+{
+    std::string name;
+    Range<int32_t> length;      // tenths
+    Range<int32_t> width;       // tenths
+    Range<int32_t> area;        // hundredths
+    ProportionKind proportionKind;
+    Range<int32_t> proportion;  // tenths
+    int32_t costMultiplier;     // e.g. the kitchen and bath cost twice their area
+};
+
+using RoomSpecTable = std::vector<RoomSpec>;
+
+// Objective bounds of a table in hundredths, used to scale the objective into a fitness.
+struct SpecCostRange
+{
+    int64_t min;
+    int64_t max;
+};
+
+// The seven rooms of the assignment, built from the constants in Rooms.hpp.
+RoomSpecTable DefaultRoomSpecs();
+
+// Reads one room per line:
+//   name lengthLow lengthHigh widthLow widthHigh areaLow areaHigh proportion costMultiplier
+// where proportion is "-" (none), a single value (fixed) or "low-high" (range), and both
+// area bounds may be "-" to derive them from the length and width bounds.
+// Blank lines and lines starting with '#' are skipped.
+// Returns false and describes the problem on errors if the file cannot be used.
+bool LoadRoomSpecs(const std::string& filename, RoomSpecTable& specs, std::ostream& errors);
+
+// Same, for a table that isn't in a file, e.g. one sent to the daemon. source names it in
+// error messages.
+bool ReadRoomSpecs(std::istream& stream, const std::string& source, RoomSpecTable& specs,
+                   std::ostream& errors);
+
+SpecCostRange GetSpecCostRange(const RoomSpecTable& specs);
+float SpecObjectiveToFitness(const SpecCostRange& range, int64_t objectiveHundredths);
+
+// The constraints of spec a room of the given size breaks, see ViolationMask.
+inline ViolationMask RoomSpecViolations(const RoomSpec& spec, int32_t length, int32_t width)
+{
+    ViolationMask violations = 0;
+    if (!spec.length.Contains(length)) violations |= LENGTH_VIOLATION;
+    if (!spec.width.Contains(width)) violations |= WIDTH_VIOLATION;
+    if (!spec.area.Contains(length * width)) violations |= AREA_VIOLATION;
+
+    bool proportionMet = true;
+    switch (spec.proportionKind)
+    {
+        case ProportionKind::FIXED:
+            proportionMet = FixedProportionEquals(length, width, spec.proportion.low) ||
+                            FixedProportionEquals(width, length, spec.proportion.low);
+            break;
+        case ProportionKind::RANGE:
+            proportionMet = FixedProportionContains(spec.proportion, length, width) ||
+                            FixedProportionContains(spec.proportion, width, length);
+            break;
+        case ProportionKind::NONE:
+        default:
+            break;
+    }
+    if (!proportionMet) violations |= PROPORTION_VIOLATION;
+
+    return violations;
+}
+
+inline bool DoesRoomFitSpec(const RoomSpec& spec, int32_t length, int32_t width)
+{
+    return RoomSpecViolations(spec, length, width) == 0;
+}
+
+// Contribution of a room to the objective function, in hundredths of a square unit.
+// An invalid room costs the maximum area of its spec, like INVALID_OBJECTIVE.
+inline int32_t RoomSpecObjective(const RoomSpec& spec, int32_t length, int32_t width)
+{
+    return DoesRoomFitSpec(spec, length, width) ? spec.costMultiplier * length * width
+                                                : spec.area.high;
+}
+
+// Same layout as PrintChromosome and PrintRoomSet, for N packed binary room words.
+void PrintPackedRooms(const std::vector<uint64_t>& rooms, const RoomSpecTable& specs,
+                      std::ostream& stream);
+void PrintSpecRoomSet(const std::vector<uint64_t>& rooms, const RoomSpecTable& specs,
+                      std::ostream& stream);
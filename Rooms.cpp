@@ -16,144 +16,76 @@ float RoomCost(const Room& room)
     return area;
 }
 
-bool DoesRoomFitConstraints(const Room& room)
+ViolationMask RoomViolations(const Room& room)
 {
     const float area = room.length * room.width;
     const float proportionLW = room.length / room.width;
     const float proportionWL = room.width / room.length;
 
+    ViolationMask violations = 0;
     switch (room.type)
     {
         case RoomType::LIVING:
-            if (!LIVING_LENGTH.Contains(room.length)) return false;
-            if (!LIVING_WIDTH.Contains(room.width)) return false;
-            if (!LIVING_AREA.Contains(area)) return false;
+            if (!LIVING_LENGTH.Contains(room.length)) violations |= LENGTH_VIOLATION;
+            if (!LIVING_WIDTH.Contains(room.width)) violations |= WIDTH_VIOLATION;
+            if (!LIVING_AREA.Contains(area)) violations |= AREA_VIOLATION;
             if (!FuzzyEquals(proportionLW, LIVING_PROPORTION) &&
                 !FuzzyEquals(proportionWL, LIVING_PROPORTION))
-                return false;
+                violations |= PROPORTION_VIOLATION;
             break;
         case RoomType::KITCHEN:
-            if (!KITCHEN_LENGTH.Contains(room.length)) return false;
-            if (!KITCHEN_WIDTH.Contains(room.width)) return false;
-            if (!KITCHEN_AREA.Contains(area)) return false;
+            if (!KITCHEN_LENGTH.Contains(room.length)) violations |= LENGTH_VIOLATION;
+            if (!KITCHEN_WIDTH.Contains(room.width)) violations |= WIDTH_VIOLATION;
+            if (!KITCHEN_AREA.Contains(area)) violations |= AREA_VIOLATION;
             if (!KITCHEN_PROPORTION.Contains(proportionLW) &&
                 !KITCHEN_PROPORTION.Contains(proportionWL))
-                return false;
+                violations |= PROPORTION_VIOLATION;
             break;
         case RoomType::BATH:
-            if (!FuzzyEquals(room.length, BATH_LENGTH)) return false;
-            if (!FuzzyEquals(room.width, BATH_WIDTH)) return false;
+            if (!FuzzyEquals(room.length, BATH_LENGTH)) violations |= LENGTH_VIOLATION;
+            if (!FuzzyEquals(room.width, BATH_WIDTH)) violations |= WIDTH_VIOLATION;
             break;
         case RoomType::HALL:
-            if (!FuzzyEquals(room.length, HALL_LENGTH)) return false;
-            if (!HALL_WIDTH.Contains(room.width)) return false;
-            if (!HALL_AREA.Contains(area)) return false;
+            if (!FuzzyEquals(room.length, HALL_LENGTH)) violations |= LENGTH_VIOLATION;
+            if (!HALL_WIDTH.Contains(room.width)) violations |= WIDTH_VIOLATION;
+            if (!HALL_AREA.Contains(area)) violations |= AREA_VIOLATION;
             if (!HALL_PROPORTION.Contains(proportionLW) && !HALL_PROPORTION.Contains(proportionWL))
-                return false;
+                violations |= PROPORTION_VIOLATION;
             break;
         case RoomType::BED1:
-            if (!BED1_LENGTH.Contains(room.length)) return false;
-            if (!BED1_WIDTH.Contains(room.width)) return false;
-            if (!BED1_AREA.Contains(area)) return false;
+            if (!BED1_LENGTH.Contains(room.length)) violations |= LENGTH_VIOLATION;
+            if (!BED1_WIDTH.Contains(room.width)) violations |= WIDTH_VIOLATION;
+            if (!BED1_AREA.Contains(area)) violations |= AREA_VIOLATION;
             if (!FuzzyEquals(proportionLW, BED1_PROPORTION) &&
                 !FuzzyEquals(proportionWL, BED1_PROPORTION))
-                return false;
+                violations |= PROPORTION_VIOLATION;
             break;
         case RoomType::BED2:
-            if (!BED2_LENGTH.Contains(room.length)) return false;
-            if (!BED2_WIDTH.Contains(room.width)) return false;
-            if (!BED2_AREA.Contains(area)) return false;
+            if (!BED2_LENGTH.Contains(room.length)) violations |= LENGTH_VIOLATION;
+            if (!BED2_WIDTH.Contains(room.width)) violations |= WIDTH_VIOLATION;
+            if (!BED2_AREA.Contains(area)) violations |= AREA_VIOLATION;
             if (!FuzzyEquals(proportionLW, BED2_PROPORTION) &&
                 !FuzzyEquals(proportionWL, BED2_PROPORTION))
-                return false;
+                violations |= PROPORTION_VIOLATION;
             break;
         case RoomType::BED3:
-            if (!BED3_LENGTH.Contains(room.length)) return false;
-            if (!BED3_WIDTH.Contains(room.width)) return false;
-            if (!BED3_AREA.Contains(area)) return false;
+            if (!BED3_LENGTH.Contains(room.length)) violations |= LENGTH_VIOLATION;
+            if (!BED3_WIDTH.Contains(room.width)) violations |= WIDTH_VIOLATION;
+            if (!BED3_AREA.Contains(area)) violations |= AREA_VIOLATION;
             if (!FuzzyEquals(proportionLW, BED3_PROPORTION) &&
                 !FuzzyEquals(proportionWL, BED3_PROPORTION))
-                return false;
+                violations |= PROPORTION_VIOLATION;
             break;
         default:
-            return false;
+            return ALL_VIOLATIONS;
     }
 
-    return true;
+    return violations;
 }
 
-RoomValidity DoesRoomFitContraintsDiganostic(const Room& room)
+bool DoesRoomFitConstraints(const Room& room)
 {
-    const float area = room.length * room.width;
-    const float proportionLW = room.length / room.width;
-    const float proportionWL = room.width / room.length;
-
-    RoomValidity validity;
-    validity.lengthMet = true;
-    validity.widthMet = true;
-    validity.xMet = true;
-    validity.yMet = true;
-    validity.areaMet = true;
-    validity.proportionMet = true;
-
-    switch (room.type)
-    {
-        case RoomType::LIVING:
-            if (!LIVING_LENGTH.Contains(room.length)) validity.lengthMet = false;
-            if (!LIVING_WIDTH.Contains(room.width)) validity.widthMet = false;
-            if (!LIVING_AREA.Contains(area)) validity.areaMet = false;
-            if (!FuzzyEquals(proportionLW, LIVING_PROPORTION) &&
-                !FuzzyEquals(proportionWL, LIVING_PROPORTION))
-                validity.proportionMet = false;
-            break;
-        case RoomType::KITCHEN:
-            if (!KITCHEN_LENGTH.Contains(room.length)) validity.lengthMet = false;
-            if (!KITCHEN_WIDTH.Contains(room.width)) validity.widthMet = false;
-            if (!KITCHEN_AREA.Contains(area)) validity.areaMet = false;
-            if (!KITCHEN_PROPORTION.Contains(proportionLW) &&
-                !KITCHEN_PROPORTION.Contains(proportionWL))
-                validity.proportionMet = false;
-            break;
-        case RoomType::BATH:
-            if (!FuzzyEquals(room.length, BATH_LENGTH)) validity.lengthMet = false;
-            if (!FuzzyEquals(room.width, BATH_WIDTH)) validity.widthMet = false;
-            break;
-        case RoomType::HALL:
-            if (!FuzzyEquals(room.length, HALL_LENGTH)) validity.lengthMet = false;
-            if (!HALL_WIDTH.Contains(room.width)) validity.widthMet = false;
-            if (!HALL_AREA.Contains(area)) validity.areaMet = false;
-            if (!HALL_PROPORTION.Contains(proportionLW) && !HALL_PROPORTION.Contains(proportionWL))
-                validity.proportionMet = false;
-            break;
-        case RoomType::BED1:
-            if (!BED1_LENGTH.Contains(room.length)) validity.lengthMet = false;
-            if (!BED1_WIDTH.Contains(room.width)) validity.widthMet = false;
-            if (!BED1_AREA.Contains(area)) validity.areaMet = false;
-            if (!FuzzyEquals(proportionLW, BED1_PROPORTION) &&
-                !FuzzyEquals(proportionWL, BED1_PROPORTION))
-                validity.proportionMet = false;
-            break;
-        case RoomType::BED2:
-            if (!BED2_LENGTH.Contains(room.length)) validity.lengthMet = false;
-            if (!BED2_WIDTH.Contains(room.width)) validity.widthMet = false;
-            if (!BED2_AREA.Contains(area)) validity.areaMet = false;
-            if (!FuzzyEquals(proportionLW, BED2_PROPORTION) &&
-                !FuzzyEquals(proportionWL, BED2_PROPORTION))
-                validity.proportionMet = false;
-            break;
-        case RoomType::BED3:
-            if (!BED3_LENGTH.Contains(room.length)) validity.lengthMet = false;
-            if (!BED3_WIDTH.Contains(room.width)) validity.widthMet = false;
-            if (!BED3_AREA.Contains(area)) validity.areaMet = false;
-            if (!FuzzyEquals(proportionLW, BED3_PROPORTION) &&
-                !FuzzyEquals(proportionWL, BED3_PROPORTION))
-                validity.proportionMet = false;
-            break;
-        default:
-            return RoomValidity{};  // should be all false
-    }
-
-    return validity;
+    return RoomViolations(room) == 0;
 }
 
 std::string_view RoomTypeToString(RoomType type)
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string_view>
 
 template <typename T>
@@ -71,18 +72,61 @@ struct Room
     RoomType type;
 };
 
-struct RoomValidity
+// Fixed-point room model.
+// Every value the GA can produce is an exact multiple of 0.1, so lengths are stored as
+// integer tenths of a unit and areas as integer hundredths of a square unit.
+// Constraint checks become integer compares and cross-multiplications, with no division.
+constexpr int32_t ToTenths(float value)
 {
-    bool lengthMet;
-    bool widthMet;
-    bool xMet;
-    bool yMet;
-    bool areaMet;
-    bool proportionMet;
-};
+    return static_cast<int32_t>(value * 10.0f + 0.5f);
+}
+
+constexpr int32_t ToHundredths(float value)
+{
+    return static_cast<int32_t>(value * 100.0f + 0.5f);
+}
+
+constexpr Range<int32_t> ToTenths(Range<float> range)
+{
+    return Range<int32_t>(ToTenths(range.low), ToTenths(range.high));
+}
+
+constexpr Range<int32_t> ToHundredths(Range<float> range)
+{
+    return Range<int32_t>(ToHundredths(range.low), ToHundredths(range.high));
+}
+
+// FuzzyEquals(a / b, proportion) with epsilon 0.01, cross-multiplied:
+// |a / b - p / 10| <= 1 / 100  <=>  |100a - 10pb| <= b, for b > 0
+constexpr bool FixedProportionEquals(int32_t a, int32_t b, int32_t proportionTenths)
+{
+    if (b <= 0) return false;
+    const int32_t difference = 100 * a - 10 * proportionTenths * b;
+    return (difference < 0 ? -difference : difference) <= b;
+}
+
+// low <= a / b <= high, cross-multiplied (bounds in tenths), for b > 0
+constexpr bool FixedProportionContains(const Range<int32_t>& proportionTenths, int32_t a,
+                                       int32_t b)
+{
+    if (b <= 0) return false;
+    return proportionTenths.low * b <= 10 * a && 10 * a <= proportionTenths.high * b;
+}
+
+// The constraints a room breaks, one bit each, so a valid room is 0. Both room models
+// (RoomViolations here, RoomSpecViolations in RoomSpec.hpp) produce it, for evaluation and
+// for the reports that mark the broken values.
+using ViolationMask = uint32_t;
+
+constexpr ViolationMask LENGTH_VIOLATION = 1u << 0;
+constexpr ViolationMask WIDTH_VIOLATION = 1u << 1;
+constexpr ViolationMask AREA_VIOLATION = 1u << 2;
+constexpr ViolationMask PROPORTION_VIOLATION = 1u << 3;
+constexpr ViolationMask ALL_VIOLATIONS =
+    LENGTH_VIOLATION | WIDTH_VIOLATION | AREA_VIOLATION | PROPORTION_VIOLATION;
 
 bool FuzzyEquals(float x, float y);
 float RoomCost(const Room& room);
+ViolationMask RoomViolations(const Room& room);
 bool DoesRoomFitConstraints(const Room& room);
-RoomValidity DoesRoomFitContraintsDiganostic(const Room& room);
 std::string_view RoomTypeToString(RoomType type);
\ No newline at end of file
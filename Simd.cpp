@@ -0,0 +1,77 @@
+#include "Simd.hpp"
+
+// the scalar kernels, built with the flags of the rest of the program
+#define AS3_SIMD_LEVEL SimdLevel::SCALAR
+#define AS3_SIMD_TABLE SCALAR_KERNELS
+#define AS3_SIMD_LANES 2
+#include "SimdKernels.hpp"
+#undef AS3_SIMD_LEVEL
+#undef AS3_SIMD_TABLE
+#undef AS3_SIMD_LANES
+
+// defined only on x86-64 builds, see CMakeLists.txt
+#ifdef AS3_X86_DISPATCH
+extern const SimdKernels AVX2_KERNELS;
+extern const SimdKernels AVX512_KERNELS;
+#endif
+
+namespace
+{
+
+const SimdKernels* forcedKernels = nullptr;
+
+}  // namespace
+
+SimdLevel DetectSimdLevel()
+{
+#ifdef AS3_X86_DISPATCH
+    // __builtin_cpu_supports also checks the OS saves the wider registers
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+        __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl"))
+        return SimdLevel::AVX512;
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+#endif
+    return SimdLevel::SCALAR;
+}
+
+bool IsSimdLevelSupported(SimdLevel level)
+{
+    return level <= DetectSimdLevel();
+}
+
+const SimdKernels& KernelsFor(SimdLevel level)
+{
+#ifdef AS3_X86_DISPATCH
+    if (level == SimdLevel::AVX512) return AVX512_KERNELS;
+    if (level == SimdLevel::AVX2) return AVX2_KERNELS;
+#endif
+    return SCALAR_KERNELS;
+}
+
+const SimdKernels& Kernels()
+{
+    static const SimdKernels& detected = KernelsFor(DetectSimdLevel());
+    return forcedKernels != nullptr ? *forcedKernels : detected;
+}
+
+bool ForceSimdLevel(SimdLevel level)
+{
+    if (!IsSimdLevelSupported(level)) return false;
+    forcedKernels = &KernelsFor(level);
+    return true;
+}
+
+std::string_view SimdLevelToString(SimdLevel level)
+{
+    switch (level)
+    {
+        case SimdLevel::AVX2:
+            return "avx2";
+        case SimdLevel::AVX512:
+            return "avx512";
+        case SimdLevel::SCALAR:
+        default:
+            return "scalar";
+    }
+}
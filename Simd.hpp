@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "RoomSpec.hpp"
+
+// Runtime CPU dispatch for the kernels that sweep whole populations or room grids.
+// Each kernel is written once (SimdKernels.hpp) and compiled into one table per instruction
+// set, with the matching -m flags on that translation unit only (see CMakeLists.txt), so
+// one binary runs on any x86-64 and still uses AVX2 or AVX-512 where the CPU has it.
+// The table is picked from CPUID on first use, unless ForceSimdLevel picked one first.
+// Every variant computes exactly the same results; only the speed differs.
+
+enum class SimdLevel
+{
+    SCALAR,  // the baseline ISA of the build
+    AVX2,
+    AVX512   // F, BW, DQ and VL
+};
+
+// min, max and sum of a float array, and the index of its first maximum
+struct SimdReduction
+{
+    float min;
+    float max;
+    double sum;  // in a fixed lane order, see SimdKernels.hpp
+    std::size_t maxIndex;
+};
+
+struct SimdKernels
+{
+    SimdLevel level;
+
+    // RoomGrayToBinary on count words, in place
+    void (*grayToBinary)(uint64_t* words, std::size_t count);
+
+    // RoomSpecObjective and DoesRoomFitSpec of count plain binary room words
+    void (*evaluateRooms)(const RoomSpec& spec, const uint64_t* words, std::size_t count,
+                          int32_t* objectives, uint8_t* fits);
+
+    // Adds the number of individuals with bit b of word w set to counts[w * 64 + b], for a
+    // population of individuals rows of words packed room words each.
+    void (*countAlleles)(const uint64_t* rows, int individuals, int words, int* counts);
+
+    // expects count > 0
+    SimdReduction (*reduce)(const float* values, std::size_t count);
+};
+
+// the active table, every hot path calls through this
+const SimdKernels& Kernels();
+
+SimdLevel DetectSimdLevel();  // the best level this CPU (and build) supports
+bool IsSimdLevelSupported(SimdLevel level);
+
+// The table of a level, whether or not the CPU can run it. Only for the tests and benchmarks.
+const SimdKernels& KernelsFor(SimdLevel level);
+
+// Makes Kernels() return the given level from now on. Call it before any worker thread
+// starts. Returns false, leaving the choice alone, if the CPU can't run that level.
+bool ForceSimdLevel(SimdLevel level);
+
+std::string_view SimdLevelToString(SimdLevel level);
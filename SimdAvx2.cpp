@@ -0,0 +1,5 @@
+// The kernels built for AVX2, only called on CPUs that have it (see Simd.cpp)
+#define AS3_SIMD_LEVEL SimdLevel::AVX2
+#define AS3_SIMD_TABLE AVX2_KERNELS
+#define AS3_SIMD_LANES 4
+#include "SimdKernels.hpp"
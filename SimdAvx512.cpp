@@ -0,0 +1,5 @@
+// The kernels built for AVX-512, only called on CPUs that have it (see Simd.cpp)
+#define AS3_SIMD_LEVEL SimdLevel::AVX512
+#define AS3_SIMD_TABLE AVX512_KERNELS
+#define AS3_SIMD_LANES 8
+#include "SimdKernels.hpp"
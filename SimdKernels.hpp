@@ -0,0 +1,236 @@
+// The kernel bodies behind SimdKernels (see Simd.hpp). No include guard: every kernel
+// translation unit includes this once, after defining
+//   AS3_SIMD_LEVEL  the SimdLevel it is compiled for
+//   AS3_SIMD_TABLE  the name of the SimdKernels table to define
+//   AS3_SIMD_LANES  64-bit lanes in one of its vector registers (2, 4 or 8)
+// and is compiled with that level's -m flags, so the compiler vectorizes the same loops for
+// each instruction set.
+//
+// Everything here has internal linkage and calls nothing inline from other headers. An inline
+// function emitted in an AVX-512 translation unit could otherwise be the copy the linker keeps
+// for the whole program, and take down the scalar build on a CPU without AVX-512.
+// Floating point sums run in a fixed lane order, so every variant computes bit-identical
+// results.
+
+#if !defined(AS3_SIMD_LEVEL) || !defined(AS3_SIMD_TABLE) || !defined(AS3_SIMD_LANES)
+#error "define AS3_SIMD_LEVEL, AS3_SIMD_TABLE and AS3_SIMD_LANES before including SimdKernels.hpp"
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "Simd.hpp"
+#include "encoding.hpp"
+
+namespace
+{
+
+// GCC and Clang vector extensions, LANES 64-bit lanes wide (one register of the level the
+// translation unit is built for, AS3_SIMD_LANES). The kernels below work on eight logical
+// lanes, as 8 / LANES of these.
+constexpr int LANES = AS3_SIMD_LANES;
+constexpr int VECTORS = 8 / LANES;
+using U64V = uint64_t __attribute__((vector_size(8 * LANES)));
+using I64V = int64_t __attribute__((vector_size(8 * LANES)));
+using F64V = double __attribute__((vector_size(8 * LANES)));
+using F32V = float __attribute__((vector_size(4 * LANES)));
+
+constexpr int LENGTH_SHIFT = 3 * FLOAT_BITWIDTH;
+constexpr int WIDTH_SHIFT = 2 * FLOAT_BITWIDTH;
+
+void GrayToBinary(uint64_t* words, std::size_t count)
+{
+    // the masks of RoomGrayToBinary, folded into constants
+    constexpr uint64_t OFFSET_1 = GeneOffsetMask(1);
+    constexpr uint64_t OFFSET_2 = GeneOffsetMask(2);
+    constexpr uint64_t OFFSET_4 = GeneOffsetMask(4);
+    constexpr uint64_t OFFSET_8 = GeneOffsetMask(8);
+
+    for (std::size_t i = 0; i < count; i++)
+    {
+        uint64_t word = words[i];
+        word ^= (word >> 1) & OFFSET_1;
+        word ^= (word >> 2) & OFFSET_2;
+        word ^= (word >> 4) & OFFSET_4;
+        word ^= (word >> 8) & OFFSET_8;
+        words[i] = word;
+    }
+}
+
+// DoesRoomFitSpec with the proportion test picked at compile time and every && turned into
+// a bitwise &, so the loop has no branches to stop it vectorizing
+template <ProportionKind Kind>
+void EvaluateRoomsOf(const RoomSpec& spec, const uint64_t* words, std::size_t count,
+                     int32_t* objectives, uint8_t* fits)
+{
+    const int32_t lengthLow = spec.length.low;
+    const int32_t lengthHigh = spec.length.high;
+    const int32_t widthLow = spec.width.low;
+    const int32_t widthHigh = spec.width.high;
+    const int32_t areaLow = spec.area.low;
+    const int32_t areaHigh = spec.area.high;
+    const int32_t proportionLow = spec.proportion.low;
+    const int32_t proportionHigh = spec.proportion.high;
+    const int32_t costMultiplier = spec.costMultiplier;
+
+    for (std::size_t i = 0; i < count; i++)
+    {
+        const int32_t length = static_cast<int32_t>((words[i] >> LENGTH_SHIFT) & GENE_MASK);
+        const int32_t width = static_cast<int32_t>((words[i] >> WIDTH_SHIFT) & GENE_MASK);
+        const int32_t area = length * width;
+
+        int32_t fit = (lengthLow <= length) & (length <= lengthHigh) & (widthLow <= width) &
+                      (width <= widthHigh) & (areaLow <= area) & (area <= areaHigh);
+        if constexpr (Kind == ProportionKind::FIXED)
+        {
+            // FixedProportionEquals both ways round
+            const int32_t lengthWise = 100 * length - 10 * proportionLow * width;
+            const int32_t widthWise = 100 * width - 10 * proportionLow * length;
+            const int32_t lengthFit =
+                (width > 0) & (lengthWise <= width) & (-lengthWise <= width);
+            const int32_t widthFit =
+                (length > 0) & (widthWise <= length) & (-widthWise <= length);
+            fit &= lengthFit | widthFit;
+        }
+        else if constexpr (Kind == ProportionKind::RANGE)
+        {
+            // FixedProportionContains both ways round
+            const int32_t lengthFit = (width > 0) & (proportionLow * width <= 10 * length) &
+                                      (10 * length <= proportionHigh * width);
+            const int32_t widthFit = (length > 0) & (proportionLow * length <= 10 * width) &
+                                     (10 * width <= proportionHigh * length);
+            fit &= lengthFit | widthFit;
+        }
+
+        objectives[i] = fit ? costMultiplier * area : areaHigh;
+        fits[i] = static_cast<uint8_t>(fit);
+    }
+}
+
+void EvaluateRooms(const RoomSpec& spec, const uint64_t* words, std::size_t count,
+                   int32_t* objectives, uint8_t* fits)
+{
+    switch (spec.proportionKind)
+    {
+        case ProportionKind::FIXED:
+            EvaluateRoomsOf<ProportionKind::FIXED>(spec, words, count, objectives, fits);
+            break;
+        case ProportionKind::RANGE:
+            EvaluateRoomsOf<ProportionKind::RANGE>(spec, words, count, objectives, fits);
+            break;
+        case ProportionKind::NONE:
+        default:
+            EvaluateRoomsOf<ProportionKind::NONE>(spec, words, count, objectives, fits);
+            break;
+    }
+}
+
+// Allele counts are gathered eight bits at a time: (word >> j) & 0x0101... puts bits j,
+// j + 8, ... of a word into the bytes of lane j, so one add counts eight alleles, and the
+// eight lanes take 8 / LANES vector adds. The byte counters are flushed before they can
+// overflow.
+void CountAlleles(const uint64_t* rows, int individuals, int words, int* counts)
+{
+    constexpr uint64_t LOW_BYTE_BITS = 0x0101010101010101;
+    constexpr int FLUSH_INTERVAL = 255;  // adds before a byte counter could overflow
+
+    U64V shifts[VECTORS];
+    for (int v = 0; v < VECTORS; v++)
+        for (int l = 0; l < LANES; l++)
+            shifts[v][l] = v * LANES + l;
+
+    for (int w = 0; w < words; w++)
+    {
+        for (int start = 0; start < individuals; start += FLUSH_INTERVAL)
+        {
+            const int end =
+                individuals - start < FLUSH_INTERVAL ? individuals : start + FLUSH_INTERVAL;
+            U64V lanes[VECTORS] = {};
+            for (int i = start; i < end; i++)
+            {
+                const U64V word = U64V{} + rows[static_cast<std::size_t>(i) * words + w];
+                for (int v = 0; v < VECTORS; v++)
+                    lanes[v] += (word >> shifts[v]) & LOW_BYTE_BITS;
+            }
+
+            for (int j = 0; j < 8; j++)
+                for (int b = 0; b < 8; b++)
+                    counts[w * 64 + b * 8 + j] += (lanes[j / LANES][j % LANES] >> (b * 8)) & 0xFF;
+        }
+    }
+}
+
+// Value i goes to lane i % 8, and the lane sums are added pairwise at the end, the same order
+// whatever the vector width. Every lane works in double (exact for a float) and keeps the
+// first index of its own maximum.
+SimdReduction Reduce(const float* values, std::size_t count)
+{
+    F64V mins[VECTORS];
+    F64V maxes[VECTORS];
+    F64V sums[VECTORS];
+    I64V maxIndices[VECTORS];
+    I64V indices[VECTORS];
+    for (int v = 0; v < VECTORS; v++)
+    {
+        mins[v] = F64V{} + values[0];
+        maxes[v] = mins[v];
+        sums[v] = F64V{};
+        maxIndices[v] = I64V{};
+        for (int l = 0; l < LANES; l++)
+            indices[v][l] = v * LANES + l;
+    }
+
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        for (int v = 0; v < VECTORS; v++)
+        {
+            F32V floats;
+            std::memcpy(&floats, values + i + v * LANES, sizeof(floats));
+            const F64V chunk = __builtin_convertvector(floats, F64V);
+            mins[v] = chunk < mins[v] ? chunk : mins[v];
+            maxIndices[v] = chunk > maxes[v] ? indices[v] : maxIndices[v];
+            maxes[v] = chunk > maxes[v] ? chunk : maxes[v];
+            sums[v] += chunk;
+            indices[v] += 8;
+        }
+    }
+    for (int j = 0; i + j < count; j++)
+    {
+        const double value = values[i + j];
+        F64V& min = mins[j / LANES];
+        F64V& max = maxes[j / LANES];
+        const int l = j % LANES;
+        min[l] = value < min[l] ? value : min[l];
+        maxIndices[j / LANES][l] = value > max[l] ? i + j : maxIndices[j / LANES][l];
+        max[l] = value > max[l] ? value : max[l];
+        sums[j / LANES][l] += value;
+    }
+
+    double laneSums[8];
+    SimdReduction reduction{values[0], values[0], 0.0, count};
+    for (int j = 0; j < 8; j++)
+    {
+        const double min = mins[j / LANES][j % LANES];
+        const double max = maxes[j / LANES][j % LANES];
+        const std::size_t index = maxIndices[j / LANES][j % LANES];
+        laneSums[j] = sums[j / LANES][j % LANES];
+
+        reduction.min = min < reduction.min ? static_cast<float>(min) : reduction.min;
+        if (max > reduction.max || (max == reduction.max && index < reduction.maxIndex))
+        {
+            reduction.max = static_cast<float>(max);
+            reduction.maxIndex = index;
+        }
+    }
+    reduction.sum = ((laneSums[0] + laneSums[1]) + (laneSums[2] + laneSums[3])) +
+                    ((laneSums[4] + laneSums[5]) + (laneSums[6] + laneSums[7]));
+    return reduction;
+}
+
+}  // namespace
+
+extern const SimdKernels AS3_SIMD_TABLE;
+const SimdKernels AS3_SIMD_TABLE = {AS3_SIMD_LEVEL, GrayToBinary, EvaluateRooms, CountAlleles,
+                                    Reduce};
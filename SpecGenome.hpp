@@ -0,0 +1,340 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory_resource>
+#include <numeric>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "GeneticAlgorithm.hpp"
+#include "PackedGenome.hpp"
+#include "RoomPool.hpp"
+#include "RoomSpec.hpp"
+#include "Simd.hpp"
+#include "encoding.hpp"
+
+// The packed bitstring genome for a building described by a RoomSpecTable.
+// The chromosome holds one packed room word per spec entry, so its length is only known
+// at runtime. Each room keeps its objective contribution next to its word, and only the
+// rooms changed by crossover or mutation are re-checked. Every check is the same
+// table-driven integer test (DoesRoomFitSpec), so the cost per room does not grow with N.
+
+struct SpecRoomGene
+{
+    uint64_t word;
+    int32_t objective;  // hundredths, only valid when the room is clean
+    bool dirty;         // changed since it was last evaluated
+};
+
+// a pmr vector, so the engine can place the room buffers in its arena
+using SpecChromosome = std::pmr::vector<SpecRoomGene>;
+
+inline int RoomCount(const SpecChromosome& chromosome)
+{
+    return static_cast<int>(chromosome.size());
+}
+
+// child = (a & ~mask) | (b & mask) per room. A room that comes out identical to one of the
+// parents' is copied whole, cached objective and dirty flag included; any other room is dirty.
+inline void Blend(std::span<const uint64_t> mask, const SpecChromosome& a, const SpecChromosome& b,
+                  SpecChromosome& child)
+{
+    child.resize(a.size());
+    for (int w = 0; w < child.size(); w++)
+    {
+        const uint64_t word = (a[w].word & ~mask[w]) | (b[w].word & mask[w]);
+        if (word == a[w].word)
+            child[w] = a[w];
+        else if (word == b[w].word)
+            child[w] = b[w];
+        else
+            child[w] = SpecRoomGene{word, 0, true};
+    }
+}
+
+inline void FlipBit(SpecChromosome& chromosome, int i)
+{
+    SpecRoomGene& room = chromosome[i / ROOM_BITWIDTH];
+    room.word ^= uint64_t{1} << (ROOM_BITWIDTH - 1 - i % ROOM_BITWIDTH);
+    room.dirty = true;
+}
+
+// Draws a random room satisfying the spec, as a plain binary room word.
+// Fixed proportions are generated from one side, otherwise we'd spin in here for a
+// Very Long Time. LoadRoomSpecs guarantees a valid room exists.
+template <typename Rng>
+uint64_t InitializeSpecRoom(Rng& generator, const RoomSpec& spec)
+{
+    std::uniform_int_distribution<int32_t> lengthDist(spec.length.low, spec.length.high);
+    std::uniform_int_distribution<int32_t> widthDist(spec.width.low, spec.width.high);
+    std::uniform_int_distribution<int32_t> positionDist(0, GENE_MASK);
+    std::bernoulli_distribution coin(0.5);
+
+    int32_t length;
+    int32_t width;
+    do
+    {
+        length = lengthDist(generator);
+        width = widthDist(generator);
+        if (spec.proportionKind == ProportionKind::FIXED)
+        {
+            const int32_t proportion = spec.proportion.low;
+            if (coin(generator))
+                width = (length * proportion + 5) / 10;
+            else
+                length = (width * proportion + 5) / 10;
+        }
+    } while (!DoesRoomFitSpec(spec, length, width));
+
+    // position is vestigial, same as InitializeRoomSet
+    return PackRoomWord(length, width, positionDist(generator), positionDist(generator));
+}
+
+// Same as InitializeSpecRoom, with the size taken from entry `index` of the room's pool.
+template <typename Rng>
+uint64_t InitializePooledRoom(Rng& generator, std::span<const uint32_t> pool, std::size_t index)
+{
+    std::uniform_int_distribution<int32_t> positionDist(0, GENE_MASK);
+    return PackRoomWord(RoomPools::EntryLength(pool[index]), RoomPools::EntryWidth(pool[index]),
+                        positionDist(generator), positionDist(generator));
+}
+
+template <GeneEncoding Encoding = GeneEncoding::BINARY>
+struct SpecGenome
+{
+    using Chromosome = SpecChromosome;
+
+    const RoomSpecTable* specs = nullptr;
+    const RoomPools* pools = nullptr;  // built from specs, only needed unless REJECTION
+    InitSampling sampling = InitSampling::REJECTION;
+
+    static uint64_t ToBinaryWord(uint64_t word)
+    {
+        if constexpr (Encoding == GeneEncoding::GRAY) return RoomGrayToBinary(word);
+        return word;
+    }
+
+    static uint64_t FromBinaryWord(uint64_t word)
+    {
+        if constexpr (Encoding == GeneEncoding::GRAY) return RoomBinaryToGray(word);
+        return word;
+    }
+
+    // room word access for the local search (see LocalSearch.hpp)
+    static uint64_t RoomWord(const Chromosome& chromosome, int i) { return chromosome[i].word; }
+
+    static void SetRoomWord(Chromosome& chromosome, int i, uint64_t word)
+    {
+        chromosome[i].word = word;
+        chromosome[i].dirty = true;
+    }
+
+    template <typename Rng>
+    void Initialize(Rng& generator, BasicIndividual<Chromosome>& x) const
+    {
+        x.chromosome.resize(specs->size());
+        for (int i = 0; i < specs->size(); i++)
+        {
+            uint64_t word;
+            if (sampling == InitSampling::REJECTION)
+                word = InitializeSpecRoom(generator, (*specs)[i]);
+            else
+            {
+                const std::span<const uint32_t> pool = pools->Sizes(i);
+                std::uniform_int_distribution<std::size_t> indexDist(0, pool.size() - 1);
+                word = InitializePooledRoom(generator, pool, indexDist(generator));
+            }
+            x.chromosome[i] = SpecRoomGene{FromBinaryWord(word), 0, true};
+        }
+    }
+
+    // Latin hypercube sampling: for every room, the population is spread over its pool with
+    // one individual per 1/N of the pool, in an independent random order per room.
+    // The other sampling modes initialize the individuals one by one.
+    template <typename Rng>
+    void InitializePopulation(Rng& generator,
+                              std::span<BasicIndividual<Chromosome>> population) const
+    {
+        if (sampling != InitSampling::STRATIFIED)
+        {
+            for (BasicIndividual<Chromosome>& x : population)
+                Initialize(generator, x);
+            return;
+        }
+
+        for (BasicIndividual<Chromosome>& x : population)
+            x.chromosome.resize(specs->size());
+
+        const std::size_t size = population.size();
+        std::vector<std::size_t> strata(size);
+        std::uniform_real_distribution<double> offsetDist(0.0, 1.0);
+        for (int i = 0; i < specs->size(); i++)
+        {
+            const std::span<const uint32_t> pool = pools->Sizes(i);
+            std::iota(strata.begin(), strata.end(), std::size_t{0});
+            std::shuffle(strata.begin(), strata.end(), generator);
+
+            for (std::size_t n = 0; n < size; n++)
+            {
+                // a uniform point within stratum strata[n], as an index into the pool
+                const double point = (strata[n] + offsetDist(generator)) / size;
+                const std::size_t index =
+                    std::min(static_cast<std::size_t>(point * pool.size()), pool.size() - 1);
+                const uint64_t word = InitializePooledRoom(generator, pool, index);
+                population[n].chromosome[i] = SpecRoomGene{FromBinaryWord(word), 0, true};
+            }
+        }
+    }
+
+    int Length() const { return static_cast<int>(specs->size()) * ROOM_BITWIDTH; }
+
+    // Hamming distance
+    static int Distance(const Chromosome& a, const Chromosome& b)
+    {
+        int differingBits = 0;
+        for (int w = 0; w < a.size(); w++)
+            differingBits += std::popcount(a[w].word ^ b[w].word);
+        return differingBits;
+    }
+
+    static std::vector<uint64_t> ToPackedRooms(const Chromosome& chromosome)
+    {
+        std::vector<uint64_t> rooms(chromosome.size());
+        PackRooms(chromosome, rooms);
+        return rooms;
+    }
+
+    // ToPackedRooms into a caller's buffer, so the diversity pass doesn't allocate
+    static void PackRooms(const Chromosome& chromosome, std::span<uint64_t> rooms)
+    {
+        for (int w = 0; w < chromosome.size(); w++)
+            rooms[w] = chromosome[w].word;
+        if constexpr (Encoding == GeneEncoding::GRAY)
+            Kernels().grayToBinary(rooms.data(), chromosome.size());
+    }
+};
+
+// Re-evaluates the dirty rooms against their specs and sums the cached contributions.
+// Builds with AS3_VALIDATE_INCREMENTAL defined check every result against a full pass.
+template <GeneEncoding Encoding = GeneEncoding::BINARY>
+struct SpecEvaluator
+{
+    const RoomSpecTable* specs = nullptr;
+    SpecCostRange costRange{0, 0};
+
+    static int32_t RoomObjective(const RoomSpec& spec, uint64_t word)
+    {
+        word = SpecGenome<Encoding>::ToBinaryWord(word);
+        return RoomSpecObjective(spec, PackedRoomLength(word), PackedRoomWidth(word));
+    }
+
+    EvaluationResult operator()(SpecChromosome& chromosome) const
+    {
+        for (int w = 0; w < chromosome.size(); w++)
+        {
+            SpecRoomGene& room = chromosome[w];
+            if (room.dirty)
+            {
+                room.objective = RoomObjective((*specs)[w], room.word);
+                room.dirty = false;
+            }
+        }
+        return Result(chromosome);
+    }
+
+    // The lock-step engine's batch (see GeneticAlgorithm::RunLockStep). The dirty rooms of
+    // all the chromosomes are gathered into one structure-of-arrays buffer per room, so each
+    // room spec takes a single grayToBinary and evaluateRooms kernel call over every trial's
+    // offspring, and the objectives are scattered back into the room caches.
+    void EvaluateBatch(std::span<SpecChromosome* const> chromosomes,
+                       std::span<EvaluationResult> results) const
+    {
+        thread_local std::vector<RoomBatch> batches;
+
+        const int rooms = chromosomes.empty() ? 0 : RoomCount(*chromosomes[0]);
+        if (batches.size() < rooms) batches.resize(rooms);
+        for (int w = 0; w < rooms; w++)
+        {
+            batches[w].words.clear();
+            batches[w].genes.clear();
+        }
+
+        for (SpecChromosome* chromosome : chromosomes)
+            for (int w = 0; w < rooms; w++)
+            {
+                SpecRoomGene& room = (*chromosome)[w];
+                if (!room.dirty) continue;
+                batches[w].words.push_back(room.word);
+                batches[w].genes.push_back(&room);
+            }
+
+        const SimdKernels& kernels = Kernels();
+        for (int w = 0; w < rooms; w++)
+        {
+            RoomBatch& batch = batches[w];
+            const std::size_t count = batch.words.size();
+            if (count == 0) continue;
+
+            batch.objectives.resize(count);
+            batch.fits.resize(count);
+            if constexpr (Encoding == GeneEncoding::GRAY)
+                kernels.grayToBinary(batch.words.data(), count);
+            kernels.evaluateRooms((*specs)[w], batch.words.data(), count,
+                                  batch.objectives.data(), batch.fits.data());
+
+            for (std::size_t i = 0; i < count; i++)
+            {
+                batch.genes[i]->objective = batch.objectives[i];
+                batch.genes[i]->dirty = false;
+            }
+        }
+
+        for (int c = 0; c < chromosomes.size(); c++)
+            results[c] = Result(*chromosomes[c]);
+    }
+
+private:
+    // one room's dirty words across the batch, kept between batches
+    struct RoomBatch
+    {
+        std::vector<uint64_t> words;
+        std::vector<SpecRoomGene*> genes;  // where each word came from
+        std::vector<int32_t> objectives;
+        std::vector<uint8_t> fits;
+    };
+
+    // sums the cached contributions of a fully clean chromosome
+    EvaluationResult Result(const SpecChromosome& chromosome) const
+    {
+        int64_t objective = 0;
+        for (const SpecRoomGene& room : chromosome)
+            objective += room.objective;
+
+#ifdef AS3_VALIDATE_INCREMENTAL
+        int64_t full = 0;
+        for (int w = 0; w < chromosome.size(); w++)
+            full += RoomObjective((*specs)[w], chromosome[w].word);
+        if (full != objective)
+        {
+            std::cerr << "Incremental evaluation mismatch: " << objective << " vs " << full << "\n";
+            std::abort();
+        }
+#endif
+
+        EvaluationResult ret;
+        ret.objective = objective / 100.0f;
+        ret.fitness = SpecObjectiveToFitness(costRange, objective);
+        return ret;
+    }
+};
+
+template <typename Selection, typename MaskGenerator = BitNPointMask,
+          GeneEncoding Encoding = GeneEncoding::BINARY>
+using SpecGeneticAlgorithm =
+    GeneticAlgorithm<SpecGenome<Encoding>, Selection, MaskCrossover<MaskGenerator>,
+                     PackedBitFlipMutation, SpecEvaluator<Encoding>>;
@@ -0,0 +1,283 @@
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <new>
+#include <string>
+#include <string_view>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Live progress telemetry.
+// The driver creates a POSIX shared memory segment holding a ring buffer, the engine writes
+// one record per generation into it and as3-top (tools/as3-top.cpp) reads it from another
+// process. Writers never wait: a record's slot is claimed with one fetch_add and written under
+// a per-slot sequence number (a seqlock), so a reader that raced a writer just retries or
+// skips the record. When the reader falls a whole ring behind, old records are overwritten.
+// A run that is killed never unlinks its segment, so Create removes every segment whose owner
+// is gone before making its own.
+
+// One generation of one trial, as seen by the reader.
+struct TelemetrySample
+{
+    uint32_t job;  // sweep configuration, 0 outside of sweeps
+    uint32_t trial;
+    uint32_t generation;
+    uint32_t generations;  // generation limit of the run
+    float bestFitness;
+    float avgFitness;
+    double evaluationsPerSecond;  // over the generation that produced this record
+};
+
+class TelemetryRing
+{
+public:
+    static constexpr uint32_t CAPACITY = 4096;
+    static constexpr uint64_t MAGIC = 0x6173332d746f7031;  // "as3-top1"
+
+    TelemetryRing() = default;
+    TelemetryRing(const TelemetryRing&) = delete;
+    TelemetryRing& operator=(const TelemetryRing&) = delete;
+
+    ~TelemetryRing()
+    {
+#ifdef __linux__
+        if (layout_ == nullptr) return;
+        if (owner_)
+        {
+            layout_->done.store(1, std::memory_order_release);
+            shm_unlink(name_.c_str());
+        }
+        munmap(layout_, sizeof(Layout));
+#endif
+    }
+
+    static constexpr std::string_view SEGMENT_PREFIX = "as3-telemetry-";  // then the owner pid
+
+    // the segment name used by the process with the given pid
+    static std::string SegmentName(long pid)
+    {
+        return "/" + std::string(SEGMENT_PREFIX) + std::to_string(pid);
+    }
+
+    static bool IsProcessRunning(long pid)
+    {
+#ifdef __linux__
+        return kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+#else
+        return false;
+#endif
+    }
+
+    // Unlinks the segments in /dev/shm left behind by processes that are no longer running.
+    static void RemoveStaleSegments()
+    {
+#ifdef __linux__
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator("/dev/shm", error))
+        {
+            const std::string name = entry.path().filename().string();
+            if (name.rfind(SEGMENT_PREFIX, 0) != 0) continue;
+
+            const long pid = std::atol(name.c_str() + SEGMENT_PREFIX.size());
+            if (pid > 0 && pid != getpid() && !IsProcessRunning(pid))
+                shm_unlink(("/" + name).c_str());
+        }
+#endif
+    }
+
+    // Creates the segment for this process. Returns false if shared memory is unavailable,
+    // in which case publishing does nothing.
+    bool Create()
+    {
+#ifdef __linux__
+        RemoveStaleSegments();
+
+        const std::string name = SegmentName(getpid());
+        const int fd = shm_open(name.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0644);
+        if (fd < 0) return false;
+
+        void* memory = MAP_FAILED;
+        if (ftruncate(fd, sizeof(Layout)) == 0)
+            memory = mmap(nullptr, sizeof(Layout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (memory == MAP_FAILED)
+        {
+            shm_unlink(name.c_str());
+            return false;
+        }
+
+        layout_ = new (memory) Layout{};
+        layout_->ownerPid = getpid();
+        layout_->magic.store(MAGIC, std::memory_order_release);
+        name_ = name;
+        owner_ = true;
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Maps an existing segment read-only.
+    bool Open(const std::string& name)
+    {
+#ifdef __linux__
+        const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) return false;
+        void* memory = mmap(nullptr, sizeof(Layout), PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (memory == MAP_FAILED) return false;
+
+        layout_ = static_cast<Layout*>(memory);
+        if (layout_->magic.load(std::memory_order_acquire) != MAGIC)
+        {
+            munmap(memory, sizeof(Layout));
+            layout_ = nullptr;
+            return false;
+        }
+        name_ = name;
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    bool IsOpen() const { return layout_ != nullptr; }
+
+    // ===== writer side, lock-free and never blocks =====
+
+    void Publish(const TelemetrySample& sample)
+    {
+        const uint64_t ticket = layout_->head.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = layout_->slots[ticket % CAPACITY];
+
+        // odd while the record is being written
+        slot.sequence.store(2 * ticket + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.job.store(sample.job, std::memory_order_relaxed);
+        slot.trial.store(sample.trial, std::memory_order_relaxed);
+        slot.generation.store(sample.generation, std::memory_order_relaxed);
+        slot.generations.store(sample.generations, std::memory_order_relaxed);
+        slot.bestFitness.store(sample.bestFitness, std::memory_order_relaxed);
+        slot.avgFitness.store(sample.avgFitness, std::memory_order_relaxed);
+        slot.evaluationsPerSecond.store(sample.evaluationsPerSecond, std::memory_order_relaxed);
+        slot.sequence.store(2 * ticket + 2, std::memory_order_release);
+    }
+
+    void AddTrials(uint32_t count) { layout_->totalTrials.fetch_add(count); }
+    void FinishTrial() { layout_->finishedTrials.fetch_add(1, std::memory_order_relaxed); }
+
+    // ===== reader side =====
+
+    // number of records ever published, record i lives in slot i % CAPACITY
+    uint64_t Head() const { return layout_->head.load(std::memory_order_acquire); }
+
+    // Copies record ticket. Returns false if it is still being written or was overwritten.
+    bool Read(uint64_t ticket, TelemetrySample& sample) const
+    {
+        const Slot& slot = layout_->slots[ticket % CAPACITY];
+        const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != 2 * ticket + 2) return false;
+
+        sample.job = slot.job.load(std::memory_order_relaxed);
+        sample.trial = slot.trial.load(std::memory_order_relaxed);
+        sample.generation = slot.generation.load(std::memory_order_relaxed);
+        sample.generations = slot.generations.load(std::memory_order_relaxed);
+        sample.bestFitness = slot.bestFitness.load(std::memory_order_relaxed);
+        sample.avgFitness = slot.avgFitness.load(std::memory_order_relaxed);
+        sample.evaluationsPerSecond = slot.evaluationsPerSecond.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slot.sequence.load(std::memory_order_relaxed) == sequence;
+    }
+
+    long OwnerPid() const { return layout_->ownerPid; }
+    uint32_t TotalTrials() const { return layout_->totalTrials.load(); }
+    uint32_t FinishedTrials() const { return layout_->finishedTrials.load(); }
+    bool Done() const { return layout_->done.load(std::memory_order_acquire) != 0; }
+
+private:
+    // a cache line per slot, so concurrent writers don't share lines
+    struct alignas(64) Slot
+    {
+        std::atomic<uint64_t> sequence;
+        std::atomic<uint32_t> job;
+        std::atomic<uint32_t> trial;
+        std::atomic<uint32_t> generation;
+        std::atomic<uint32_t> generations;
+        std::atomic<float> bestFitness;
+        std::atomic<float> avgFitness;
+        std::atomic<double> evaluationsPerSecond;
+    };
+
+    struct Layout
+    {
+        std::atomic<uint64_t> magic;
+        int64_t ownerPid;
+        std::atomic<uint32_t> totalTrials;
+        std::atomic<uint32_t> finishedTrials;
+        std::atomic<uint32_t> done;
+        alignas(64) std::atomic<uint64_t> head;
+        Slot slots[CAPACITY];
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free &&
+                      std::atomic<double>::is_always_lock_free,
+                  "the ring is shared between processes, its atomics must be address-free");
+
+    Layout* layout_ = nullptr;
+    std::string name_;
+    bool owner_ = false;
+};
+
+// What the engine on this thread publishes to: which ring, and which job and trial it is
+// running. Like ThreadArena(), the driver sets it up before each run.
+struct TelemetryChannel
+{
+    TelemetryRing* ring = nullptr;  // nothing is published without one or a listener
+    uint32_t job = 0;
+    uint32_t trial = 0;
+    std::chrono::steady_clock::time_point last{};
+
+    // also gets every record, on the engine's thread (the daemon streams them to its clients)
+    std::function<void(const TelemetrySample&)> listener;
+
+    bool IsActive() const { return ring != nullptr || listener; }
+
+    void Start()
+    {
+        if (IsActive()) last = std::chrono::steady_clock::now();
+    }
+
+    void Publish(int generation, int generations, float bestFitness, float avgFitness,
+                 int evaluations)
+    {
+        if (!IsActive()) return;
+
+        const auto now = std::chrono::steady_clock::now();
+        const double seconds = std::chrono::duration<double>(now - last).count();
+        last = now;
+        const TelemetrySample sample{job, trial, static_cast<uint32_t>(generation),
+                                     static_cast<uint32_t>(generations), bestFitness,
+                                     avgFitness, seconds > 0.0 ? evaluations / seconds : 0.0};
+        if (ring != nullptr) ring->Publish(sample);
+        if (listener) listener(sample);
+    }
+};
+
+inline TelemetryChannel& ThreadTelemetry()
+{
+    thread_local TelemetryChannel channel;
+    return channel;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Runs a batch of independent jobs on a fixed set of worker threads with work stealing.
+// The jobs are dealt out round robin, each worker runs its own deque from the back and,
+// once that is empty, steals from the front of the other workers' deques. Long and short
+// jobs (e.g. large and small populations) therefore even out without a central queue.
+class WorkStealingPool
+{
+public:
+    using Job = std::function<void()>;
+
+    explicit WorkStealingPool(int threads)
+        : queues_(std::max(threads, 1))
+    {
+    }
+
+    int ThreadCount() const { return static_cast<int>(queues_.size()); }
+
+    // Runs every job and returns once all of them have finished.
+    // Jobs must not throw and must not add jobs to the pool.
+    void Run(std::vector<Job> jobs)
+    {
+        stolen_ = 0;
+        for (std::size_t i = 0; i < jobs.size(); i++)
+            queues_[i % queues_.size()].jobs.push_back(std::move(jobs[i]));
+
+        std::vector<std::thread> workers;
+        for (int i = 1; i < ThreadCount(); i++)
+            workers.emplace_back([this, i] { Work(i); });
+        Work(0);  // the calling thread is worker 0
+
+        for (std::thread& worker : workers)
+            worker.join();
+    }
+
+    // number of jobs taken from another worker's deque during the last Run
+    std::size_t StolenJobs() const { return stolen_; }
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    void Work(int self)
+    {
+        Job job;
+        while (Pop(self, job) || Steal(self, job))
+            job();
+    }
+
+    bool Pop(int self, Job& job)
+    {
+        Queue& queue = queues_[self];
+        std::lock_guard lock(queue.mutex);
+        if (queue.jobs.empty()) return false;
+        job = std::move(queue.jobs.back());
+        queue.jobs.pop_back();
+        return true;
+    }
+
+    // no job is ever added during Run, so one pass over empty deques means we're done
+    bool Steal(int self, Job& job)
+    {
+        for (int offset = 1; offset < ThreadCount(); offset++)
+        {
+            Queue& victim = queues_[(self + offset) % ThreadCount()];
+            std::lock_guard lock(victim.mutex);
+            if (victim.jobs.empty()) continue;
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            stolen_++;
+            return true;
+        }
+        return false;
+    }
+
+    std::vector<Queue> queues_;
+    std::atomic<std::size_t> stolen_ = 0;
+};
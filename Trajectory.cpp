@@ -0,0 +1,184 @@
+#include "Trajectory.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string_view>
+
+namespace
+{
+
+constexpr std::string_view TRAJECTORY_HEADER = "as3-trajectory 1";
+
+std::string JoinArgs(const std::vector<std::string>& args)
+{
+    std::string joined;
+    for (const std::string& arg : args)
+        joined += (joined.empty() ? "" : " ") + arg;
+    return joined.empty() ? "(defaults)" : joined;
+}
+
+double TotalMilliseconds(const Trajectory& trajectory)
+{
+    double total = 0.0;
+    for (const TrajectoryTrial& trial : trajectory.trials)
+        total += trial.milliseconds;
+    return total;
+}
+
+}  // namespace
+
+uint64_t HashRooms(const std::vector<uint64_t>& rooms)
+{
+    uint64_t hash = SplitMix64(rooms.size());
+    for (uint64_t word : rooms)
+        hash = SplitMix64(hash ^ word);
+    return hash;
+}
+
+TrajectoryTrial RecordTrajectory(const Statistics& stats, double milliseconds)
+{
+    TrajectoryTrial trial;
+    trial.seed = stats.seed;
+    trial.lastGeneration = stats.lastGeneration;
+    trial.milliseconds = milliseconds;
+    trial.fingerprint = 0;
+
+    // generations past lastGeneration only repeat the final one
+    stats.fittest.ForEachGeneration(stats.lastGeneration, [&](int, const FittestIndividual& best) {
+        const uint64_t hash = HashRooms(best.rooms);
+        trial.generationHashes.push_back(hash);
+        trial.fingerprint = SplitMix64(trial.fingerprint ^ hash);
+    });
+    return trial;
+}
+
+void WriteTrajectory(const Trajectory& trajectory, std::ostream& stream)
+{
+    // one trial per line: seed, last generation, milliseconds, fingerprint, generation hashes
+    stream << TRAJECTORY_HEADER << "\n";
+    stream << "seed " << trajectory.masterSeed << "\n";
+    stream << "args";
+    for (const std::string& arg : trajectory.args)
+        stream << " " << arg;
+    stream << "\n";
+
+    for (const TrajectoryTrial& trial : trajectory.trials)
+    {
+        stream << "trial " << trial.seed << " " << trial.lastGeneration << " " << std::fixed
+               << std::setprecision(3) << trial.milliseconds << " " << std::hex
+               << std::setfill('0') << std::setw(16) << trial.fingerprint;
+        for (uint64_t hash : trial.generationHashes)
+            stream << " " << std::setw(16) << hash;
+        stream << std::dec << std::setfill(' ') << "\n";
+    }
+}
+
+bool ReadTrajectory(const std::string& filename, Trajectory& trajectory, std::ostream& errors)
+{
+    std::ifstream file(filename);
+    if (!file)
+    {
+        errors << "Could not open trajectory file " << filename << "\n";
+        return false;
+    }
+
+    std::string line;
+    if (!std::getline(file, line) || line != TRAJECTORY_HEADER)
+    {
+        errors << filename << " is not a trajectory file\n";
+        return false;
+    }
+
+    Trajectory loaded{};
+    for (int lineNumber = 2; std::getline(file, line); lineNumber++)
+    {
+        std::stringstream ss(line);
+        std::string kind;
+        if (!(ss >> kind)) continue;
+
+        bool valid = true;
+        if (kind == "seed")
+            valid = static_cast<bool>(ss >> loaded.masterSeed);
+        else if (kind == "args")
+        {
+            for (std::string arg; ss >> arg;)
+                loaded.args.push_back(arg);
+        }
+        else if (kind == "trial")
+        {
+            TrajectoryTrial trial;
+            valid = static_cast<bool>(ss >> trial.seed >> trial.lastGeneration >>
+                                      trial.milliseconds >> std::hex >> trial.fingerprint);
+            for (uint64_t hash; ss >> hash;)
+                trial.generationHashes.push_back(hash);
+            valid = valid && ss.eof() && trial.generationHashes.size() == trial.lastGeneration + 1;
+            loaded.trials.push_back(std::move(trial));
+        }
+        else
+            valid = false;
+
+        if (!valid)
+        {
+            errors << filename << ":" << lineNumber << ": malformed trajectory line\n";
+            return false;
+        }
+    }
+
+    trajectory = std::move(loaded);
+    return true;
+}
+
+bool CompareTrajectories(const Trajectory& baseline, const Trajectory& candidate,
+                         std::ostream& report)
+{
+    if (baseline.masterSeed != candidate.masterSeed || baseline.args != candidate.args ||
+        baseline.trials.size() != candidate.trials.size())
+    {
+        report << "The runs are not the same experiment:\n"
+               << "  baseline:  seed " << baseline.masterSeed << ", " << baseline.trials.size()
+               << " trials, " << JoinArgs(baseline.args) << "\n"
+               << "  candidate: seed " << candidate.masterSeed << ", " << candidate.trials.size()
+               << " trials, " << JoinArgs(candidate.args) << "\n";
+        return false;
+    }
+
+    int diverged = 0;
+    for (int t = 0; t < baseline.trials.size(); t++)
+    {
+        const TrajectoryTrial& a = baseline.trials[t];
+        const TrajectoryTrial& b = candidate.trials[t];
+        if (a.generationHashes == b.generationHashes) continue;
+
+        const auto [first, ignored] = std::mismatch(
+            a.generationHashes.begin(), a.generationHashes.end(), b.generationHashes.begin(),
+            b.generationHashes.end());
+        report << "Trial " << t << " (seed " << a.seed << ") diverges at generation "
+               << first - a.generationHashes.begin() << "\n";
+        diverged++;
+    }
+
+    const double baselineMs = TotalMilliseconds(baseline);
+    const double candidateMs = TotalMilliseconds(candidate);
+
+    // the median of the per-trial ratios shrugs off the odd trial that got descheduled
+    std::vector<double> ratios;
+    for (int t = 0; t < baseline.trials.size(); t++)
+        if (baseline.trials[t].milliseconds > 0.0)
+            ratios.push_back(candidate.trials[t].milliseconds / baseline.trials[t].milliseconds);
+    std::sort(ratios.begin(), ratios.end());
+    const double medianRatio = ratios.empty() ? 1.0 : ratios[ratios.size() / 2];
+
+    report << std::fixed << std::setprecision(3);
+    report << baseline.trials.size() - diverged << "/" << baseline.trials.size()
+           << " trials followed the same trajectory\n";
+    report << "Baseline:  " << baselineMs << " ms total\n";
+    report << "Candidate: " << candidateMs << " ms total\n";
+    report << "Candidate / baseline: " << (baselineMs > 0.0 ? candidateMs / baselineMs : 1.0)
+           << " total, " << medianRatio << " median per trial";
+    if (diverged > 0) report << " (not comparable, the runs did different work)";
+    report << "\n";
+
+    return diverged == 0;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "GeneticAlgorithm.hpp"
+
+// Deterministic replay.
+// A run is driven by one master seed, every trial's seed is derived from it, so the same
+// master seed and flags make the GA do exactly the same work. The run records a trajectory:
+// a hash of each generation's best chromosome plus the time every trial took. Two builds
+// that do the same work produce the same hashes, and only then are their timings comparable.
+
+struct TrajectoryTrial
+{
+    std::random_device::result_type seed;
+    int lastGeneration;
+    double milliseconds;   // time spent in the GA itself, no output
+    uint64_t fingerprint;  // all generation hashes chained together
+    std::vector<uint64_t> generationHashes;
+};
+
+struct Trajectory
+{
+    uint64_t masterSeed;
+    std::vector<std::string> args;  // every flag except --seed and --replay
+    std::vector<TrajectoryTrial> trials;
+};
+
+constexpr uint64_t SplitMix64(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EB;
+    return x ^ (x >> 31);
+}
+
+// The seed of trial (or sweep job) index. Neighbouring indices get unrelated seeds.
+constexpr std::random_device::result_type DeriveTrialSeed(uint64_t masterSeed, uint64_t index)
+{
+    using Seed = std::random_device::result_type;
+    return static_cast<Seed>(SplitMix64(masterSeed ^ SplitMix64(index)));
+}
+
+// Hashes one generation's best chromosome (as plain binary room words).
+uint64_t HashRooms(const std::vector<uint64_t>& rooms);
+
+// Hashes generations 0..lastGeneration of a finished run.
+TrajectoryTrial RecordTrajectory(const Statistics& stats, double milliseconds);
+
+void WriteTrajectory(const Trajectory& trajectory, std::ostream& stream);
+bool ReadTrajectory(const std::string& filename, Trajectory& trajectory, std::ostream& errors);
+
+// Reports where the candidate diverges from the baseline and, if they match, how much faster
+// or slower it ran. Returns true if both did exactly the same work.
+bool CompareTrajectories(const Trajectory& baseline, const Trajectory& candidate,
+                         std::ostream& report);
@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string_view>
+#include <vector>
+
+#include "../GeneticAlgorithm.hpp"
+#include "../GridGenome.hpp"
+
+// Compares generations-to-target for binary and Gray coded genes,
+// and for the integer grid genome that skips decoding altogether.
+// All genomes run the same seeds, so the comparison is paired trial by trial.
+// Usage: bench-encoding [target fitness] [trials] [base seed]
+
+struct BenchResult
+{
+    int reached = 0;
+    std::vector<int> generations;  // generations-to-target of the trials that reached it
+    double milliseconds = 0.0;
+};
+
+template <typename Engine>
+BenchResult RunTrials(const GAConfig& config, int trials, unsigned int baseSeed)
+{
+    BenchResult result;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < trials; i++)
+    {
+        Engine ga(config);
+        Statistics stats = ga.Run(baseSeed + i);
+        if (stats.stopReason == StopReason::TARGET_FITNESS)
+        {
+            result.reached++;
+            result.generations.push_back(stats.lastGeneration);
+        }
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    result.milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+    return result;
+}
+
+void PrintResult(std::string_view name, const BenchResult& result, int trials)
+{
+    std::vector<int> sorted = result.generations;
+    std::sort(sorted.begin(), sorted.end());
+
+    double mean = 0.0;
+    for (int gens : sorted)
+        mean += gens;
+    if (!sorted.empty()) mean /= sorted.size();
+
+    std::cout << std::left << std::setw(8) << name << std::right << std::setw(6) << result.reached
+              << "/" << std::setw(3) << std::left << trials << std::right << std::fixed
+              << std::setprecision(2) << std::setw(12) << mean << std::setw(10)
+              << (sorted.empty() ? -1 : sorted[sorted.size() / 2]) << std::setw(12)
+              << result.milliseconds << "\n";
+}
+
+int main(int argc, char** argv)
+{
+    GAConfig config;
+    config.targetFitness = 85.0f;
+    int trials = 30;
+    unsigned int baseSeed = std::random_device{}();
+
+    if (argc > 1) std::stringstream(argv[1]) >> config.targetFitness;
+    if (argc > 2) std::stringstream(argv[2]) >> trials;
+    if (argc > 3) std::stringstream(argv[3]) >> baseSeed;
+
+    std::cout << "Target fitness " << config.targetFitness << ", " << trials
+              << " trials, base seed " << baseSeed << ", at most " << NUM_GENERATIONS
+              << " generations\n";
+    std::cout << "Encoding Reached     MeanGens   MedianGens   WallMs\n";
+
+    using BinaryGA = DefaultGeneticAlgorithm<RouletteSelection, GeneEncoding::BINARY>;
+    using GrayGA = DefaultGeneticAlgorithm<RouletteSelection, GeneEncoding::GRAY>;
+    using GridGA = GridGeneticAlgorithm<RouletteSelection>;
+
+    PrintResult("binary", RunTrials<BinaryGA>(config, trials, baseSeed), trials);
+    PrintResult("gray", RunTrials<GrayGA>(config, trials, baseSeed), trials);
+    PrintResult("grid", RunTrials<GridGA>(config, trials, baseSeed), trials);
+
+    return 0;
+}
@@ -0,0 +1,145 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string_view>
+
+#include "../Rooms.hpp"
+
+// Validates the fixed-point proportion and area checks against the float expressions of
+// DoesRoomFitConstraints over every (length, width) pair a 10-bit gene can encode, then times
+// both. The length and width bounds are plain compares in either model, so they aren't here.
+// The models only disagree on pairs exactly on a bound, which float rounding puts on either
+// side, and on a zero side, where the float path divides by zero.
+
+constexpr int GRID_SIZE = 1 << 10;
+
+// a gene value as DecodePackedRoom turns it into a float
+float ToFloat(int tenths)
+{
+    return static_cast<float>(tenths) * 0.1;
+}
+
+// Returns the mismatches that are neither on a bound nor on a zero side.
+template <typename FloatCheck, typename FixedCheck, typename OnBound>
+int Compare(std::string_view name, FloatCheck floatCheck, FixedCheck fixedCheck, OnBound onBound)
+{
+    int validFloat = 0;
+    int validFixed = 0;
+    int mismatches = 0;
+    int ties = 0;
+    for (int32_t length = 0; length < GRID_SIZE; length++)
+    {
+        for (int32_t width = 0; width < GRID_SIZE; width++)
+        {
+            const bool floatValid = floatCheck(ToFloat(length), ToFloat(width));
+            const bool fixedValid = fixedCheck(length, width);
+            validFloat += floatValid;
+            validFixed += fixedValid;
+            if (floatValid == fixedValid) continue;
+
+            mismatches++;
+            if (length == 0 || width == 0 || onBound(length, width))
+            {
+                ties++;
+                continue;
+            }
+            std::cout << "  " << name << " " << ToFloat(length) << " x " << ToFloat(width)
+                      << ": float " << floatValid << ", fixed " << fixedValid << "\n";
+        }
+    }
+
+    // timing, the sums keep the compiler from discarding the checks
+    constexpr int repetitions = 5;
+    int floatSum = 0;
+    int fixedSum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; r++)
+        for (int32_t length = 0; length < GRID_SIZE; length++)
+            for (int32_t width = 0; width < GRID_SIZE; width++)
+                floatSum += floatCheck(ToFloat(length), ToFloat(width));
+    auto middle = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; r++)
+        for (int32_t length = 0; length < GRID_SIZE; length++)
+            for (int32_t width = 0; width < GRID_SIZE; width++)
+                fixedSum += fixedCheck(length, width);
+    auto end = std::chrono::steady_clock::now();
+
+    const double checks = static_cast<double>(repetitions) * GRID_SIZE * GRID_SIZE;
+    const double floatNs = std::chrono::duration<double, std::nano>(middle - start).count();
+    const double fixedNs = std::chrono::duration<double, std::nano>(end - middle).count();
+
+    std::cout << std::left << std::setw(20) << name << std::right << std::setw(10) << validFloat
+              << std::setw(11) << validFixed << std::setw(11) << mismatches << std::setw(6) << ties
+              << std::fixed
+              << std::setprecision(3) << std::setw(10) << floatNs / checks << std::setw(10)
+              << fixedNs / checks << std::defaultfloat << "  (" << floatSum + fixedSum << ")\n";
+    return mismatches - ties;
+}
+
+int CompareProportion(std::string_view name, float proportion)
+{
+    const int32_t tenths = ToTenths(proportion);
+    return Compare(
+        name,
+        [=](float length, float width) {
+            return FuzzyEquals(length / width, proportion) ||
+                   FuzzyEquals(width / length, proportion);
+        },
+        [=](int32_t length, int32_t width) {
+            return FixedProportionEquals(length, width, tenths) ||
+                   FixedProportionEquals(width, length, tenths);
+        },
+        [=](int32_t length, int32_t width) {
+            return std::abs(100 * length - 10 * tenths * width) == width ||
+                   std::abs(100 * width - 10 * tenths * length) == length;
+        });
+}
+
+int CompareProportion(std::string_view name, Range<float> proportion)
+{
+    const Range<int32_t> tenths = ToTenths(proportion);
+    return Compare(
+        name,
+        [=](float length, float width) {
+            return proportion.Contains(length / width) || proportion.Contains(width / length);
+        },
+        [=](int32_t length, int32_t width) {
+            return FixedProportionContains(tenths, length, width) ||
+                   FixedProportionContains(tenths, width, length);
+        },
+        [=](int32_t length, int32_t width) {
+            for (int32_t bound : {tenths.low, tenths.high})
+                if (10 * length == bound * width || 10 * width == bound * length) return true;
+            return false;
+        });
+}
+
+int CompareArea(std::string_view name, Range<float> area)
+{
+    const Range<int32_t> hundredths = ToHundredths(area);
+    return Compare(
+        name, [=](float length, float width) { return area.Contains(length * width); },
+        [=](int32_t length, int32_t width) { return hundredths.Contains(length * width); },
+        [=](int32_t length, int32_t width) {
+            return length * width == hundredths.low || length * width == hundredths.high;
+        });
+}
+
+int main()
+{
+    int unexplained = 0;
+
+    std::cout << "Check               ValidFloat ValidFixed Mismatches  Ties   FloatNs   FixedNs\n";
+    unexplained += CompareProportion("proportion 1.5", LIVING_PROPORTION);
+    unexplained += CompareProportion("proportion 1.0-1.5", KITCHEN_PROPORTION);
+    unexplained += CompareArea("Living area", LIVING_AREA);
+    unexplained += CompareArea("Kitchen area", KITCHEN_AREA);
+    unexplained += CompareArea("Hall area", HALL_AREA);
+    unexplained += CompareArea("Bed 1 area", BED1_AREA);
+    unexplained += CompareArea("Bed 2 area", BED2_AREA);
+    unexplained += CompareArea("Bed 3 area", BED3_AREA);
+
+    std::cout << "Mismatches off a bound: " << unexplained << "\n";
+    return 0;
+}
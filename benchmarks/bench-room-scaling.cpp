@@ -0,0 +1,65 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+#include "../GeneticAlgorithm.hpp"
+#include "../PackedGenome.hpp"
+#include "../RoomSpec.hpp"
+#include "../SpecGenome.hpp"
+
+// Times full GA runs on the spec genome for buildings of growing size, made by repeating
+// the built-in seven rooms. Time per room and individual should stay flat as N grows.
+// Usage: bench-room-scaling [trials] [base seed]
+
+// with the default population and generation count
+constexpr double EVALUATIONS_PER_TRIAL = GENERATION_SIZE * (NUM_GENERATIONS + 1.0);
+
+template <typename Engine>
+double TimeTrials(Engine& ga, int trials, unsigned int baseSeed)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < trials; i++)
+        ga.Run(baseSeed + i);
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void PrintRow(std::string_view name, int rooms, double milliseconds, int trials)
+{
+    const double nsPerRoom = milliseconds * 1e6 / (trials * EVALUATIONS_PER_TRIAL * rooms);
+    std::cout << std::left << std::setw(12) << name << std::right << std::setw(6) << rooms
+              << std::fixed << std::setprecision(2) << std::setw(12) << milliseconds / trials
+              << std::setw(14) << nsPerRoom << "\n";
+}
+
+int main(int argc, char** argv)
+{
+    int trials = 20;
+    unsigned int baseSeed = std::random_device{}();
+
+    if (argc > 1) std::stringstream(argv[1]) >> trials;
+    if (argc > 2) std::stringstream(argv[2]) >> baseSeed;
+
+    std::cout << trials << " trials, base seed " << baseSeed << "\n";
+    std::cout << "Engine       Rooms   MsPerTrial  NsPerRoomEval\n";
+
+    GAConfig config;
+    const RoomSpecTable defaults = DefaultRoomSpecs();
+    for (int copies : {1, 2, 6, 12, 29})
+    {
+        RoomSpecTable specs;
+        for (int i = 0; i < copies; i++)
+            for (const RoomSpec& spec : defaults)
+                specs.push_back(spec);
+
+        SpecGeneticAlgorithm<RouletteSelection> ga(
+            config, RouletteSelection{}, MaskCrossover<BitNPointMask>{CROSSOVER_PROB, {1}},
+            PackedBitFlipMutation{MUTATION_PROB}, SpecEvaluator<>{&specs, GetSpecCostRange(specs)},
+            SpecGenome<>{&specs});
+        PrintRow("spec", static_cast<int>(specs.size()), TimeTrials(ga, trials, baseSeed), trials);
+    }
+
+    return 0;
+}
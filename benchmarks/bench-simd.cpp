@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string_view>
+#include <vector>
+
+#include "../RoomSpec.hpp"
+#include "../Simd.hpp"
+#include "../encoding.hpp"
+
+// Times every kernel of every SimdKernels table this CPU can run, on population sized inputs.
+// The checksums must agree across levels, the kernels are meant to be bit-identical.
+// Usage: bench-simd [elements] [repetitions]
+
+template <typename Kernel>
+double TimeKernel(int repetitions, Kernel kernel)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; r++)
+        kernel();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / repetitions;
+}
+
+void PrintRow(std::string_view level, std::string_view kernel, double nsPerElement,
+              uint64_t checksum)
+{
+    std::cout << std::left << std::setw(8) << level << std::setw(15) << kernel << std::right
+              << std::fixed << std::setprecision(3) << std::setw(12) << nsPerElement << "  "
+              << std::hex << checksum << std::dec << "\n";
+}
+
+int main(int argc, char** argv)
+{
+    int elements = 1 << 20;
+    int repetitions = 20;
+    if (argc > 1) std::stringstream(argv[1]) >> elements;
+    if (argc > 2) std::stringstream(argv[2]) >> repetitions;
+
+    // a population of elements / NUM_ROOMS individuals, one word per room
+    std::mt19937_64 generator(776);
+    const int individuals = elements / NUM_ROOMS;
+    std::vector<uint64_t> words(individuals * NUM_ROOMS);
+    for (uint64_t& word : words)
+        word = generator() & ROOM_WORD_MASK;
+    std::vector<float> values(elements);
+    std::uniform_real_distribution<float> valueDist(0.0f, 100.0f);
+    for (float& value : values)
+        value = valueDist(generator);
+
+    const RoomSpec kitchen = DefaultRoomSpecs()[1];
+    std::vector<uint64_t> decoded(words.size());
+    std::vector<int32_t> objectives(words.size());
+    std::vector<uint8_t> fits(words.size());
+    std::vector<int> counts(NUM_ROOMS * 64);
+
+    std::cout << "Detected " << SimdLevelToString(DetectSimdLevel()) << ", " << words.size()
+              << " words, " << repetitions << " repetitions\n";
+    std::cout << "Level   Kernel          NsPerElement  Checksum\n";
+    for (SimdLevel level : {SimdLevel::SCALAR, SimdLevel::AVX2, SimdLevel::AVX512})
+    {
+        if (!IsSimdLevelSupported(level)) continue;
+        const SimdKernels& kernels = KernelsFor(level);
+        const std::string_view name = SimdLevelToString(level);
+
+        double ns = TimeKernel(repetitions, [&] {
+            decoded = words;
+            kernels.grayToBinary(decoded.data(), decoded.size());
+        });
+        uint64_t checksum = 0;
+        for (uint64_t word : decoded)
+            checksum = checksum * 31 + word;
+        PrintRow(name, "grayToBinary", ns / words.size(), checksum);
+
+        ns = TimeKernel(repetitions, [&] {
+            kernels.evaluateRooms(kitchen, words.data(), words.size(), objectives.data(),
+                                  fits.data());
+        });
+        checksum = 0;
+        for (std::size_t i = 0; i < words.size(); i++)
+            checksum = checksum * 31 + objectives[i] + fits[i];
+        PrintRow(name, "evaluateRooms", ns / words.size(), checksum);
+
+        ns = TimeKernel(repetitions, [&] {
+            std::fill(counts.begin(), counts.end(), 0);
+            kernels.countAlleles(words.data(), individuals, NUM_ROOMS, counts.data());
+        });
+        checksum = 0;
+        for (int count : counts)
+            checksum = checksum * 31 + count;
+        PrintRow(name, "countAlleles", ns / words.size(), checksum);
+
+        SimdReduction reduction{};
+        ns = TimeKernel(repetitions, [&] { reduction = kernels.reduce(values.data(), elements); });
+        checksum = std::bit_cast<uint64_t>(reduction.sum) ^ reduction.maxIndex;
+        PrintRow(name, "reduce", ns / elements, checksum);
+    }
+
+    return 0;
+}
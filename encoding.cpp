@@ -1,8 +1,33 @@
 #include "encoding.hpp"
 
+#include <algorithm>
+#include <charconv>
 #include <cmath>
 #include <cstdio>
-#include <iomanip>
+
+namespace
+{
+
+// value with six decimals, right aligned in width, padded and framed by the marker
+char* WriteRoomCell(char* out, float value, int width, bool violated)
+{
+    constexpr char INVALID_MARKER = '~';
+    const char marker = violated ? INVALID_MARKER : ' ';
+
+    // the widest value is an area just under 102.3 * 102.3, well inside this
+    char digits[32];
+    char* end =
+        std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::fixed, 6).ptr;
+
+    *out++ = marker;
+    out = std::fill_n(out, std::max(0, width - static_cast<int>(end - digits)), marker);
+    out = std::copy(digits, end, out);
+    *out++ = marker;
+    *out++ = '|';
+    return out;
+}
+
+}  // namespace
 
 // The float encoder transforms a value in the range [0, 102.3]
 // into a bitsting of width 10.
@@ -43,6 +68,13 @@ Chromosome EncodeChromosome(const RoomSet& rooms)
     return ret;
 }
 
+Chromosome EncodeChromosome(const RoomSet& rooms, GeneEncoding encoding)
+{
+    Chromosome ret = EncodeChromosome(rooms);
+    if (encoding == GeneEncoding::GRAY) ret = BinaryToGray(ret);
+    return ret;
+}
+
 float DecodeFloat(const Gene& bitstring)
 {
     int ival = 0;
@@ -84,6 +116,77 @@ RoomSet DecodeChromosome(const Chromosome& chromosome)
     return ret;
 }
 
+RoomSet DecodeChromosome(const Chromosome& chromosome, GeneEncoding encoding)
+{
+    if (encoding == GeneEncoding::BINARY) return DecodeChromosome(chromosome);
+
+    PackedChromosome packed = PackChromosome(chromosome);
+    for (uint64_t& word : packed)
+        word = RoomGrayToBinary(word);
+    return DecodePackedChromosome(packed);
+}
+
+PackedChromosome PackChromosome(const Chromosome& chromosome)
+{
+    PackedChromosome ret;
+    for (int i = 0; i < NUM_ROOMS; i++)
+    {
+        uint64_t word = 0;
+        for (int k = 0; k < ROOM_BITWIDTH; k++)
+            word = (word << 1) | (chromosome[(i * ROOM_BITWIDTH) + k] & 1);
+        ret[i] = word;
+    }
+    return ret;
+}
+
+Chromosome UnpackChromosome(const PackedChromosome& packed)
+{
+    Chromosome ret;
+    for (int i = 0; i < NUM_ROOMS; i++)
+        for (int k = 0; k < ROOM_BITWIDTH; k++)
+            ret[(i * ROOM_BITWIDTH) + k] = (packed[i] >> (ROOM_BITWIDTH - 1 - k)) & 1;
+    return ret;
+}
+
+Room DecodePackedRoom(uint64_t word, int index)
+{
+    static constexpr std::array<RoomType, NUM_ROOMS> roomTypes = {
+        RoomType::LIVING, RoomType::KITCHEN, RoomType::BATH, RoomType::HALL,
+        RoomType::BED1,   RoomType::BED2,    RoomType::BED3};
+
+    Room room;
+    room.length = static_cast<float>((word >> (3 * FLOAT_BITWIDTH)) & GENE_MASK) * 0.1;
+    room.width = static_cast<float>((word >> (2 * FLOAT_BITWIDTH)) & GENE_MASK) * 0.1;
+    room.x = static_cast<float>((word >> FLOAT_BITWIDTH) & GENE_MASK) * 0.1;
+    room.y = static_cast<float>(word & GENE_MASK) * 0.1;
+    room.type = roomTypes[index];
+    return room;
+}
+
+RoomSet DecodePackedChromosome(const PackedChromosome& packed)
+{
+    RoomSet ret;
+    for (int i = 0; i < NUM_ROOMS; i++)
+        ret[i] = DecodePackedRoom(packed[i], i);
+    return ret;
+}
+
+Chromosome BinaryToGray(const Chromosome& chromosome)
+{
+    PackedChromosome packed = PackChromosome(chromosome);
+    for (uint64_t& word : packed)
+        word = RoomBinaryToGray(word);
+    return UnpackChromosome(packed);
+}
+
+Chromosome GrayToBinary(const Chromosome& chromosome)
+{
+    PackedChromosome packed = PackChromosome(chromosome);
+    for (uint64_t& word : packed)
+        word = RoomGrayToBinary(word);
+    return UnpackChromosome(packed);
+}
+
 // This function assumes that all the rooms are valid beforehand.
 // (i.e. DoesRoomFitConstraints returns true for all rooms.)
 float ObjectiveFunction(const RoomSet& rooms)
@@ -111,19 +214,14 @@ void PrintChromosome(const Chromosome& chromosome, std::ostream& stream)
         RoomType::LIVING, RoomType::KITCHEN, RoomType::BATH, RoomType::HALL,
         RoomType::BED1,   RoomType::BED2,    RoomType::BED3};
 
+    const PackedChromosome packed = PackChromosome(chromosome);
     stream << "            Length     | Width      | x Pos      | y Pos      | Type\n";
     stream << "Chromosome: ";
     for (int i = 0; i < NUM_ROOMS; i++)
     {
-        for (int j = 0; j < 4; j++)
-        {
-            for (int k = 0; k < FLOAT_BITWIDTH; k++)
-            {
-                int index = (i * ROOM_BITWIDTH) + (j * FLOAT_BITWIDTH) + k;
-                stream << static_cast<int>(chromosome[index]);
-            }
-            stream << " | ";
-        }
+        std::array<char, ROOM_REPORT_LINE> line;
+        char* out = WriteRoomBits(line.data(), packed[i]);
+        stream.write(line.data(), out - line.data());
         stream << RoomTypeToString(roomTypes[i]) << "\n";
 
         if (i != NUM_ROOMS - 1) stream << "            ";
@@ -132,43 +230,47 @@ void PrintChromosome(const Chromosome& chromosome, std::ostream& stream)
 
 void PrintRoomSet(const RoomSet& rooms, std::ostream& stream)
 {
-    constexpr char invalidMarker = '~';
-
     stream << "            Length     | Width      | x Pos      | y Pos      | Area         | "
            << "PropLW     | PropWL     | Type\n";
     stream << "RoomSet...: ";
     for (int i = 0; i < NUM_ROOMS; i++)
     {
         const Room& room = rooms[i];
-        RoomValidity validity = DoesRoomFitContraintsDiganostic(room);
-
-        const float area = room.length * room.width;
-        const float proportionLW = room.width > 0.0f ? room.length / room.width : 0.0f;
-        const float proportionWL = room.length > 0.0f ? room.width / room.length : 0.0f;
-
-        char marker = (validity.lengthMet ? ' ' : invalidMarker);
-        stream << marker << std::setfill(marker) << std::fixed << std::setw(9)
-               << std::setprecision(6) << room.length << marker << '|';
-        marker = (validity.widthMet ? ' ' : invalidMarker);
-        stream << marker << std::setfill(marker) << std::fixed << std::setw(10)
-               << std::setprecision(6) << room.width << marker << '|';
-        marker = (validity.xMet ? ' ' : invalidMarker);
-        stream << marker << std::setfill(marker) << std::fixed << std::setw(10)
-               << std::setprecision(6) << room.x << marker << '|';  // vestigial
-        marker = (validity.yMet ? ' ' : invalidMarker);
-        stream << marker << std::setfill(marker) << std::fixed << std::setw(10)
-               << std::setprecision(6) << room.y << marker << '|';  // vestigial
-        marker = (validity.areaMet ? ' ' : invalidMarker);
-        stream << marker << std::setfill(marker) << std::fixed << std::setw(12)
-               << std::setprecision(6) << area << marker << '|';
-        marker = (validity.proportionMet ? ' ' : invalidMarker);
-        stream << marker << std::setfill(marker) << std::fixed << std::setw(10)
-               << std::setprecision(6) << proportionLW << marker << '|';
-        marker = (validity.proportionMet ? ' ' : invalidMarker);
-        stream << marker << std::setfill(marker) << std::fixed << std::setw(10)
-               << std::setprecision(6) << proportionWL << marker << '|';
+
+        std::array<char, ROOM_REPORT_LINE> line;
+        char* out = WriteRoomCells(line.data(), RoomViolations(room), room.length, room.width,
+                                   room.x, room.y);
+        stream.write(line.data(), out - line.data());
         stream << ' ' << RoomTypeToString(room.type) << "\n";
 
         if (i != NUM_ROOMS - 1) stream << "            ";
     }
 }
+
+char* WriteRoomBits(char* out, uint64_t word)
+{
+    for (int bit = ROOM_BITWIDTH - 1; bit >= 0; bit--)
+    {
+        *out++ = static_cast<char>('0' + ((word >> bit) & 1));
+        if (bit % FLOAT_BITWIDTH == 0) out = std::copy_n(" | ", 3, out);
+    }
+    return out;
+}
+
+char* WriteRoomCells(char* out, ViolationMask violations, float length, float width, float x,
+                     float y)
+{
+    const float area = length * width;
+    const float proportionLW = width > 0.0f ? length / width : 0.0f;
+    const float proportionWL = length > 0.0f ? width / length : 0.0f;
+    const bool badProportion = violations & PROPORTION_VIOLATION;
+
+    out = WriteRoomCell(out, length, 9, violations & LENGTH_VIOLATION);
+    out = WriteRoomCell(out, width, 10, violations & WIDTH_VIOLATION);
+    out = WriteRoomCell(out, x, 10, false);  // vestigial
+    out = WriteRoomCell(out, y, 10, false);  // vestigial
+    out = WriteRoomCell(out, area, 12, violations & AREA_VIOLATION);
+    out = WriteRoomCell(out, proportionLW, 10, badProportion);
+    out = WriteRoomCell(out, proportionWL, 10, badProportion);
+    return out;
+}
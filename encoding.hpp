@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <ostream>
 
@@ -17,18 +18,108 @@ constexpr std::array INVALID_OBJECTIVE = {
     LIVING_AREA.high, KITCHEN_AREA.high, BATH_WIDTH * BATH_LENGTH, HALL_AREA.high,
     BED1_AREA.high,   BED2_AREA.high,    BED3_AREA.high};
 
+// Living, Kitchen, Bath, Hall, Bed1, Bed2, Bed3 is the assumed order.
+constexpr std::array<RoomType, NUM_ROOMS> ROOM_TYPES = {
+    RoomType::LIVING, RoomType::KITCHEN, RoomType::BATH, RoomType::HALL,
+    RoomType::BED1,   RoomType::BED2,    RoomType::BED3};
+
 using RoomSet = std::array<Room, NUM_ROOMS>;
 using Gene = std::array<uint8_t, FLOAT_BITWIDTH>;
 using Chromosome = std::array<uint8_t, CHROMOSOME_BITWIDTH>;
 
+// How a float's grid index is mapped onto its 10 gene bits.
+// With Gray coding, adjacent grid values (e.g. 51.1 and 51.2) always differ in exactly one bit.
+enum class GeneEncoding
+{
+    BINARY,
+    GRAY
+};
+
+// The packed chromosome stores one room per 64-bit word, most significant gene first:
+// bits 39..30 = length, 29..20 = width, 19..10 = x, 9..0 = y, bits 63..40 are always 0.
+// Chromosome bit (i * ROOM_BITWIDTH) + k lives in word i at bit (ROOM_BITWIDTH - 1 - k).
+using PackedChromosome = std::array<uint64_t, NUM_ROOMS>;
+
+constexpr uint64_t GENE_MASK = (uint64_t{1} << FLOAT_BITWIDTH) - 1;
+constexpr uint64_t ROOM_WORD_MASK = (uint64_t{1} << ROOM_BITWIDTH) - 1;
+
+// Bits of a room word whose offset from the most significant bit of their gene is >= offset.
+constexpr uint64_t GeneOffsetMask(int offset)
+{
+    uint64_t mask = 0;
+    for (int gene = 0; gene < 4; gene++)
+        for (int bit = 0; bit < FLOAT_BITWIDTH - offset; bit++)
+            mask |= uint64_t{1} << (gene * FLOAT_BITWIDTH + bit);
+    return mask;
+}
+
+// Gray code of every gene in a room word at once: g = b ^ (b >> 1), without letting
+// the least significant bit of one gene leak into the most significant bit of the next.
+constexpr uint64_t RoomBinaryToGray(uint64_t word)
+{
+    return word ^ ((word >> 1) & GeneOffsetMask(1));
+}
+
+// Inverse of RoomBinaryToGray: each bit becomes the XOR of all more significant bits of its
+// gene, computed as a segmented prefix XOR in log2(FLOAT_BITWIDTH) steps.
+constexpr uint64_t RoomGrayToBinary(uint64_t word)
+{
+    word ^= (word >> 1) & GeneOffsetMask(1);
+    word ^= (word >> 2) & GeneOffsetMask(2);
+    word ^= (word >> 4) & GeneOffsetMask(4);
+    word ^= (word >> 8) & GeneOffsetMask(8);
+    return word;
+}
+
 Gene EncodeFloat(float val);
 Chromosome EncodeChromosome(const RoomSet& rooms);
+Chromosome EncodeChromosome(const RoomSet& rooms, GeneEncoding encoding);
 
 float DecodeFloat(const Gene& bitstring);
 RoomSet DecodeChromosome(const Chromosome& chromosome);
+RoomSet DecodeChromosome(const Chromosome& chromosome, GeneEncoding encoding);
+
+PackedChromosome PackChromosome(const Chromosome& chromosome);
+Chromosome UnpackChromosome(const PackedChromosome& packed);
+RoomSet DecodePackedChromosome(const PackedChromosome& packed);
+Room DecodePackedRoom(uint64_t word, int index);  // index selects the room type
+
+// The gene values of a (binary) packed room are already its dimensions in tenths.
+constexpr int32_t PackedRoomLength(uint64_t word)
+{
+    return static_cast<int32_t>((word >> (3 * FLOAT_BITWIDTH)) & GENE_MASK);
+}
+
+constexpr int32_t PackedRoomWidth(uint64_t word)
+{
+    return static_cast<int32_t>((word >> (2 * FLOAT_BITWIDTH)) & GENE_MASK);
+}
+
+constexpr uint64_t PackRoomWord(uint64_t length, uint64_t width, uint64_t x, uint64_t y)
+{
+    return ((length & GENE_MASK) << (3 * FLOAT_BITWIDTH)) |
+           ((width & GENE_MASK) << (2 * FLOAT_BITWIDTH)) | ((x & GENE_MASK) << FLOAT_BITWIDTH) |
+           (y & GENE_MASK);
+}
+
+// Convert every gene of a chromosome between plain binary and Gray coding.
+Chromosome BinaryToGray(const Chromosome& chromosome);
+Chromosome GrayToBinary(const Chromosome& chromosome);
 
 float ObjectiveFunction(const RoomSet& rooms);
 float ObjectiveToFitness(float objectiveValue);
 
 void PrintChromosome(const Chromosome& chromosome, std::ostream& stream);
 void PrintRoomSet(const RoomSet& rooms, std::ostream& stream);
+
+// The room reports build each line with std::to_chars in a buffer of ROOM_REPORT_LINE
+// characters and write it in one go, rather than a stream manipulator per value.
+constexpr std::size_t ROOM_REPORT_LINE = 128;
+
+// The four genes of a packed room word, PrintChromosome style ("0110010100 | " each).
+char* WriteRoomBits(char* out, uint64_t word);
+
+// The Length to PropWL cells of a PrintRoomSet line, with the values that break one of the
+// violations marked by '~'.
+char* WriteRoomCells(char* out, ViolationMask violations, float length, float width, float x,
+                     float y);
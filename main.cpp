@@ -1,84 +1,200 @@
+#include <algorithm>
 #include <array>
+#include <chrono>
 #include <cmath>
 #include <cstdint>
 #include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <optional>
 #include <random>
+#include <span>
 #include <sstream>
+#include <string>
+#include <string_view>
 #include <thread>
 #include <vector>
 
 #define cimg_display 0
 #include "CImg/CImg.h"
+#include "Daemon.hpp"
+#include "GeneticAlgorithm.hpp"
+#include "GridGenome.hpp"
+#include "Optimizers.hpp"
+#include "PackedGenome.hpp"
+#include "RoomPool.hpp"
+#include "RoomSpec.hpp"
 #include "Rooms.hpp"
+#include "Simd.hpp"
+#include "SpecGenome.hpp"
+#include "Telemetry.hpp"
+#include "ThreadPool.hpp"
+#include "Trajectory.hpp"
 #include "encoding.hpp"
 
 constexpr int NUM_TRIALS = 30;
-constexpr int NUM_GENERATIONS = 50;
-constexpr int GENERATION_SIZE = 100;
-constexpr double CROSSOVER_PROB = 0.7;
-constexpr double MUTATION_PROB = 0.001;
 
-struct EvaluationResult
+// Options of the driver itself, as opposed to the GA (GAConfig).
+struct RunOptions
 {
-    float objective;
-    float fitness;
+    std::string roomSpecFile;
+    std::string sweepFile;
+    int trials = NUM_TRIALS;
+    int threads = 0;  // sweep and daemon worker threads, 0 uses every core
+    std::optional<uint64_t> masterSeed;  // drawn from std::random_device if not given
+    std::string replayFile;
+    bool telemetry = true;  // publish live progress for as3-top
+    std::string serveEndpoint;  // socket path, or "-" for stdin and stdout
+    std::optional<SimdLevel> simdLevel;  // detected from the CPU if not given
+    bool lockStep = false;  // run the trials together, see GeneticAlgorithm::RunLockStep
 };
 
-struct Individual
-{
-    Chromosome chromosome;
-    float objective;
-    float fitness;
-};
+bool ParseArguments(const std::vector<std::string>& args, GAConfig& config, RunOptions& options,
+                    std::ostream& errors = std::cerr);
+bool LoadSpecs(const GAConfig& config, const std::string& roomSpecFile, RoomSpecTable& specs);
+bool SearchesGrid(const GAConfig& config);
+std::vector<std::string> ReplayableArgs(const std::vector<std::string>& args);
+bool RunSweep(const std::vector<std::string>& args, const RunOptions& options,
+              TelemetryRing& telemetry);
+bool RunDaemon(const std::vector<std::string>& args, const RunOptions& options);
+using TrialSeeds = std::span<const std::random_device::result_type>;
+Statistics RunGeneticAlgorithm(const GAConfig& config, const RoomSpecTable& specs,
+                               const RoomPools& pools, std::random_device::result_type seed);
+std::vector<Statistics> RunTrials(const GAConfig& config, const RoomSpecTable& specs,
+                                  const RoomPools& pools, TrialSeeds seeds);
+template <GeneEncoding Encoding>
+std::vector<Statistics> RunTrials(const GAConfig& config, const RoomSpecTable& specs,
+                                  const RoomPools& pools, TrialSeeds seeds);
+template <typename Genome, typename Crossover, typename Mutation, typename Evaluator>
+std::vector<Statistics> RunTrials(const GAConfig& config, Genome genome, Crossover crossover,
+                                  Mutation mutation, Evaluator evaluator, TrialSeeds seeds);
+void OutputStatistics(const Statistics& stats, const RoomSpecTable& specs,
+                      std::ostream& csvSummary, std::ostream& bestText,
+                      const std::string& bestImageFilename);
+void OutputDiversity(const Statistics& stats, const RoomSpecTable& specs, std::ostream& csv);
+void DrawRooms(const std::vector<uint64_t>& rooms, const RoomSpecTable& specs,
+               const std::string& filename);
 
-struct Statistics
-{
-    std::random_device::result_type seed;
-    std::array<Individual, NUM_GENERATIONS + 1> fittestIndividuals;
+// TODO: do the reliability, quality, speed metrics thing
 
-    // The +1 is so we include the initial generation
-    std::array<float, NUM_GENERATIONS + 1> minFitnesses;
-    std::array<float, NUM_GENERATIONS + 1> maxFitnesses;
-    std::array<float, NUM_GENERATIONS + 1> avgFitnesses;
+int main(int argc, char** argv)
+{
+    const std::vector<std::string> args(argv + 1, argv + argc);
+    GAConfig config;
+    RunOptions options;
+    if (!ParseArguments(args, config, options)) return 1;
 
-    std::array<float, NUM_GENERATIONS + 1> minObjective;
-    std::array<float, NUM_GENERATIONS + 1> maxObjective;
-    std::array<float, NUM_GENERATIONS + 1> avgObjective;
-};
+    // before any worker thread can pick up the detected kernels
+    if (options.simdLevel && !ForceSimdLevel(*options.simdLevel))
+    {
+        std::cerr << "This CPU can't run the " << SimdLevelToString(*options.simdLevel)
+                  << " kernels\n";
+        return 1;
+    }
+    if (!options.serveEndpoint.empty()) return RunDaemon(args, options) ? 0 : 1;
 
-using Population = std::array<Individual, GENERATION_SIZE>;
-using ProbDist = std::array<double, GENERATION_SIZE>;
+    // a replay runs the flags and master seed recorded in the trajectory file
+    Trajectory trajectory{0, ReplayableArgs(args), {}};
+    Trajectory replayed;
+    if (!options.replayFile.empty())
+    {
+        if (args.size() != 2)
+        {
+            std::cerr << "--replay takes every other setting from the trajectory file\n";
+            return 1;
+        }
 
-Statistics RunGeneticAlgorithm();
-void GenerationStatistics(Statistics& stats, const Population& population, int gen);
-void OutputStatistics(const Statistics& stats, std::ostream& csvSummary, std::ostream& bestText,
-                      const std::string& bestImageFilename);
-float GenerateFloatInRange(std::mt19937& generator, const Range<float> range);
-void InitializeIndividual(std::mt19937& generator, Individual& x);
-void DrawRoomSet(const RoomSet& roomSet, const std::string& filename);
-EvaluationResult EvaluateIndividual(const RoomSet& rooms);
-ProbDist MakeCumulativeProbDist(const Population& pop);
-std::array<Individual, 2> Select(std::mt19937& generator, const ProbDist& cdf, const Population& pop);
-std::array<Individual, 2> Crossover(std::mt19937& generator, const std::array<Individual, 2>& parents);
-uint8_t MutateBit(std::mt19937& generator, uint8_t bit);
+        const std::string replayFile = options.replayFile;
+        if (!ReadTrajectory(replayFile, replayed, std::cerr)) return 1;
+        config = GAConfig{};
+        options = RunOptions{};
+        if (!ParseArguments(replayed.args, config, options)) return 1;
+        options.masterSeed = replayed.masterSeed;
+        options.replayFile = replayFile;
+        trajectory.args = replayed.args;
+        std::cout << "Replaying " << replayFile << "\n";
+    }
 
-// TODO: do the reliability, quality, speed metrics thing
+    if (!options.masterSeed)
+    {
+        std::random_device device{};
+        options.masterSeed = uint64_t{device()} << 32 | device();
+    }
+    trajectory.masterSeed = *options.masterSeed;
+    std::cout << "Master seed " << trajectory.masterSeed << " (--seed " << trajectory.masterSeed
+              << " repeats this run)\n";
 
-int main()
-{
     // Make sure the data directory exists
     if (!std::filesystem::exists("data")) std::filesystem::create_directory("data");
 
+    TelemetryRing telemetry;
+    if (options.telemetry && telemetry.Create())
+        std::cout << "Live progress: as3-top " << telemetry.OwnerPid() << "\n";
+
+    if (!options.sweepFile.empty()) return RunSweep(args, options, telemetry) ? 0 : 1;
+
+    RoomSpecTable specs;
+    if (!LoadSpecs(config, options.roomSpecFile, specs)) return 1;
+    if (!options.roomSpecFile.empty())
+        std::cout << "Loaded " << specs.size() << " rooms from " << options.roomSpecFile << "\n";
+
+    // every trial draws its initial rooms from the same read-only pools
+    const RoomPools pools(specs);
+
     // We need to summarize the summary statistics for each generation
-    // (The average is over NUM_TRIALS runs)
-    std::array<Statistics, NUM_TRIALS> uberStats;
+    // (The average is over options.trials runs)
+    // (on the heap, they are a few KB each)
+    std::vector<Statistics> uberStats(options.trials);
+    if (telemetry.IsOpen()) telemetry.AddTrials(options.trials);
+    TelemetryRing* ring = telemetry.IsOpen() ? &telemetry : nullptr;
+
+    // in lock step every trial runs up front, and each is charged an equal share of the time
+    std::vector<Statistics> lockStepStats;
+    double lockStepMilliseconds = 0.0;
+    if (options.lockStep)
+    {
+        std::vector<std::random_device::result_type> seeds;
+        for (int i = 0; i < options.trials; i++)
+            seeds.push_back(DeriveTrialSeed(trajectory.masterSeed, i));
+        std::cout << "Running " << options.trials << " " << OptimizerKindToString(config.optimizer)
+                  << " trials in lock step...\n";
+
+        ThreadTelemetry() = TelemetryChannel{ring, 0, 0};
+        auto start = std::chrono::steady_clock::now();
+        lockStepStats = RunTrials(config, specs, pools, seeds);
+        auto end = std::chrono::steady_clock::now();
+        for (int i = 0; ring != nullptr && i < options.trials; i++)
+            ring->FinishTrial();
+        lockStepMilliseconds =
+            std::chrono::duration<double, std::milli>(end - start).count() / options.trials;
+    }
 
-    for (int i = 0; i < NUM_TRIALS; i++)
+    for (int i = 0; i < options.trials; i++)
     {
-        Statistics stats = RunGeneticAlgorithm();
+        Statistics stats;
+        double milliseconds = lockStepMilliseconds;
+        if (options.lockStep)
+            stats = std::move(lockStepStats[i]);
+        else
+        {
+            auto seed = DeriveTrialSeed(trajectory.masterSeed, i);
+            std::cout << "Running " << OptimizerKindToString(config.optimizer) << " with seed "
+                      << static_cast<unsigned int>(seed) << "...\n";
+
+            ThreadTelemetry() = TelemetryChannel{ring, 0, static_cast<uint32_t>(i)};
+
+            auto start = std::chrono::steady_clock::now();
+            stats = RunGeneticAlgorithm(config, specs, pools, seed);
+            auto end = std::chrono::steady_clock::now();
+            if (ring != nullptr) ring->FinishTrial();
+            milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+        }
+        trajectory.trials.push_back(RecordTrajectory(stats, milliseconds));
+
         std::stringstream ss;
         ss << "data/stats-trial-" << i << ".csv";
         std::ofstream outFile(ss.str());
@@ -91,12 +207,31 @@ int main()
         ss << "data/best-trial-" << i << ".png";
         std::string bestImage = ss.str();
 
-        OutputStatistics(stats, outFile, bestText, bestImage);
+        std::cout << "Trial " << i << " stopped after generation " << stats.lastGeneration << " ("
+                  << StopReasonToString(stats.stopReason) << "), "
+                  << stats.evaluations[stats.lastGeneration] << " evaluations + "
+                  << stats.localSearchEvaluations[stats.lastGeneration]
+                  << " local search, population memory "
+                  << std::fixed << std::setprecision(2) << stats.populationBytes / 1048576.0
+                  << " MiB\n";
+
+        OutputStatistics(stats, specs, outFile, bestText, bestImage);
+        if (config.diversityStats)
+        {
+            ss.str("");
+            ss << "data/diversity-trial-" << i << ".csv";
+            std::ofstream diversityFile(ss.str());
+            OutputDiversity(stats, specs, diversityFile);
+        }
         uberStats[i] = stats;
     }
 
+    std::ofstream trajectoryFile("data/trajectory.txt");
+    WriteTrajectory(trajectory, trajectoryFile);
+
     Statistics uberSummary;
-    for (int i = 0; i < NUM_GENERATIONS + 1; i++)
+    ResizeStatistics(uberSummary, config.generations);
+    for (int i = 0; i < config.generations + 1; i++)
     {
         float sumMinObjective = 0.0f;
         float sumMaxObjective = 0.0f;
@@ -106,6 +241,12 @@ int main()
         float sumMaxFitness = 0.0f;
         float sumAvgFitness = 0.0f;
 
+        int64_t sumEvaluations = 0;
+        int64_t sumLocalSearchEvaluations = 0;
+
+        float sumMutationRate = 0.0f;
+        float sumCrossoverRate = 0.0f;
+
         for (const Statistics& stats : uberStats)
         {
             sumMinObjective += stats.minObjective[i];
@@ -115,6 +256,12 @@ int main()
             sumMinFitness += stats.minFitnesses[i];
             sumMaxFitness += stats.maxFitnesses[i];
             sumAvgFitness += stats.avgFitnesses[i];
+
+            sumEvaluations += stats.evaluations[i];
+            sumLocalSearchEvaluations += stats.localSearchEvaluations[i];
+
+            sumMutationRate += stats.mutationRates[i];
+            sumCrossoverRate += stats.crossoverRates[i];
         }
 
         uberSummary.minObjective[i] = sumMinObjective / uberStats.size();
@@ -124,11 +271,23 @@ int main()
         uberSummary.minFitnesses[i] = sumMinFitness / uberStats.size();
         uberSummary.maxFitnesses[i] = sumMaxFitness / uberStats.size();
         uberSummary.avgFitnesses[i] = sumAvgFitness / uberStats.size();
+
+        uberSummary.evaluations[i] = sumEvaluations / uberStats.size();
+        uberSummary.localSearchEvaluations[i] = sumLocalSearchEvaluations / uberStats.size();
+
+        uberSummary.mutationRates[i] = sumMutationRate / uberStats.size();
+        uberSummary.crossoverRates[i] = sumCrossoverRate / uberStats.size();
     }
 
+    const Arena& arena = ThreadArena();
+    std::cout << "Population arena: " << std::fixed << std::setprecision(2)
+              << arena.PeakBytesUsed() / 1048576.0 << " MiB peak, "
+              << arena.BytesReserved() / 1048576.0 << " MiB reserved in " << arena.BlockCount()
+              << " huge page aligned block(s)\n";
+
     std::ofstream outFile("data/stats-average.csv");
     std::ofstream bestText("/dev/null");
-    OutputStatistics(uberSummary, outFile, bestText, "");
+    OutputStatistics(uberSummary, specs, outFile, bestText, "");
 
     // find the fittest overall individual across all trials
     int fittestTrial = 0;
@@ -136,324 +295,1027 @@ int main()
     float maxFitness = std::numeric_limits<float>::lowest();
     for (int i = 0; i < uberStats.size(); i++)
     {
-        for (int j = 0; j < uberStats[i].fittestIndividuals.size(); j++)
+        const int generation = uberStats[i].fittest.FittestGeneration(config.generations);
+        const float fitness = uberStats[i].maxFitnesses[generation];
+        if (fitness > maxFitness)
         {
-            const Individual& individual = uberStats[i].fittestIndividuals[j];
-            if (individual.fitness > maxFitness)
-            {
-                maxFitness = individual.fitness;
-                fittestTrial = i;
-                fittestGeneration = j;
-            }
+            maxFitness = fitness;
+            fittestTrial = i;
+            fittestGeneration = generation;
         }
     }
 
     std::ofstream bestOverall("data/best-overall.txt");
-    const Individual& bestOverallIndividual = uberStats[fittestTrial].fittestIndividuals[fittestGeneration];
+    const FittestIndividual bestOverallIndividual =
+        uberStats[fittestTrial].fittest.At(fittestGeneration);
     bestOverall << std::fixed << std::setprecision(6);
     bestOverall << "========== FITTEST INDIVIDUAL ACROSS ALL TRIALS ==========\n";
     bestOverall << "Trial.....: " << fittestTrial << "\n";
     bestOverall << "Generation: " << fittestGeneration << "\n";
     bestOverall << "Fitness...: " << maxFitness << "\n";
     bestOverall << "Objective.: " << bestOverallIndividual.objective << "\n";
-    PrintChromosome(bestOverallIndividual.chromosome, bestOverall);
-    auto bestOverallRoomSet = DecodeChromosome(bestOverallIndividual.chromosome);
-    PrintRoomSet(bestOverallRoomSet, bestOverall);
-    DrawRoomSet(bestOverallRoomSet, "data/best-overall.png");
+    PrintPackedRooms(bestOverallIndividual.rooms, specs, bestOverall);
+    PrintSpecRoomSet(bestOverallIndividual.rooms, specs, bestOverall);
+    DrawRooms(bestOverallIndividual.rooms, specs, "data/best-overall.png");
+
+    if (!options.replayFile.empty())
+    {
+        std::cout << "\nReplay of " << options.replayFile << " (baseline) by this build:\n";
+        if (!CompareTrajectories(replayed, trajectory, std::cout)) return 1;
+    }
 
     return 0;
 }
 
-Statistics RunGeneticAlgorithm()
+bool ParseArguments(const std::vector<std::string>& args, GAConfig& config, RunOptions& options,
+                    std::ostream& errors)
 {
-    Statistics stats;
+    constexpr std::string_view usage =
+        "Usage: as3 [--trials T] [--generations G] [--population N] [--elitism K]\n"
+        "           [--crossover-prob P] [--mutation-prob P] [--adaptive-rates on|off]\n"
+        "           [--target-fitness F] [--stall-generations S] [--min-diversity D]\n"
+        "           [--diversity-stats on|off]\n"
+        "           [--selection roulette|tournament|rank] [--tournament-size K] "
+        "[--rank-pressure S]\n"
+        "           [--genome bitstring|grid] [--encoding binary|gray]\n"
+        "           [--crossover npoint|gene|room|uniform] [--crossover-points N]\n"
+        "           [--sbx-index ETA] [--grid-mutation-prob P] [--grid-mutation-sigma S]\n"
+        "           [--optimizer ga|de|sa|es] [--de-weight F] [--de-crossover-prob CR]\n"
+        "           [--sa-temperature T] [--es-offspring L]\n"
+        "           [--local-search none|lamarckian|baldwinian] [--local-search-top-k K]\n"
+        "           [--local-search-budget E] [--init rejection|pool|stratified]\n"
+        "           [--rooms FILE] [--sweep FILE] [--threads N] [--seed S] [--telemetry on|off]\n"
+        "           [--simd auto|scalar|avx2|avx512] [--lock-step on|off]\n"
+        "       as3 --replay FILE\n"
+        "       as3 --serve -|SOCKET [--threads N] [--telemetry on|off] [--simd LEVEL]\n"
+        "\n"
+        "Every trial's seed is derived from one master seed (--seed, random by default), and\n"
+        "data/trajectory.txt records a hash of each generation's best chromosome. --replay\n"
+        "re-runs the flags and seed of a trajectory file and checks this build follows it.\n"
+        "\n"
+        "--adaptive-rates on starts from the given mutation and crossover rates and adapts\n"
+        "them every generation. The mutation rate follows the 1/5 success rule (up while more\n"
+        "than a fifth of the children beat both parents, down otherwise), the crossover rate\n"
+        "moves towards whichever of crossed and uncrossed children did better. The rates of\n"
+        "every generation are in the MutationRate and CrossoverRate columns of the stats.\n"
+        "\n"
+        "--local-search hill climbs the K fittest individuals of every generation over their\n"
+        "(length, width) grid neighbours, E evaluations at most each. Lamarckian keeps the\n"
+        "refined chromosomes, Baldwinian only their fitness (so its reported layouts are the\n"
+        "unrefined ones). Local search evaluations are counted separately in the outputs.\n"
+        "\n"
+        "--init picks how the initial room sizes are drawn: rejection sampling, uniformly from\n"
+        "the valid sizes of each room (pool, the default), or a Latin hypercube over them\n"
+        "(stratified). The grid genome always uses rejection sampling.\n"
+        "\n"
+        "--simd picks the instruction set of the population kernels (the best one the CPU\n"
+        "has by default). Every level gives the same results, it is there for benchmarking.\n"
+        "\n"
+        "--optimizer swaps the GA for differential evolution (de, DE/rand/1/bin), simulated\n"
+        "annealing (sa) or a (mu + lambda) evolution strategy with self-adaptive step sizes\n"
+        "(es, mu is --population). All three search the grid genome's integer codes, moving\n"
+        "genes by --grid-mutation-sigma grid steps (SA, and the ES's initial step size), and\n"
+        "write the same statistics, so evaluations to --target-fitness and time per trial\n"
+        "compare directly, e.g. with a sweep over grid --optimizer ga de sa es. An SA\n"
+        "generation is --population moves, cooling from --sa-temperature (in fitness units)\n"
+        "to a thousandth of it by the last generation.\n"
+        "\n"
+        "--lock-step on advances all the trials a generation at a time together and evaluates\n"
+        "their offspring as one batch, which fills the kernels better than one population.\n"
+        "Each trial keeps its own seed and gives the same results as on its own. Sweeps and\n"
+        "the daemon always run trials one at a time.\n"
+        "\n"
+        "--serve keeps as3 running and reads jobs as JSON lines from stdin (-) or a Unix\n"
+        "socket, e.g.\n"
+        "  {\"id\": 1, \"args\": [\"--trials\", \"5\"], \"seed\": 42, \"rooms\": [\"...\"]}\n"
+        "where rooms holds lines of a --rooms file. Every generation and trial is reported\n"
+        "back as a JSON line, and nothing is written under data/.\n"
+        "\n"
+        "A sweep file runs every (configuration, trial) pair on a thread pool and writes\n"
+        "data/sweep-results.csv. Each line is one of\n"
+        "  config --flag value ...    a configuration, as flags on top of the command line\n"
+        "  grid --flag value value... a grid axis, every configuration is run with each value\n"
+        "and the sweep is every config line (or just the command line) times every grid point.\n";
+
+    for (int i = 0; i < args.size(); i++)
+    {
+        std::string_view arg = args[i];
+        if (i + 1 >= args.size())
+        {
+            errors << "Missing value for " << arg << "\n" << usage;
+            return false;
+        }
 
-    std::random_device device{};
-    auto seed = device();
-    std::mt19937 generator{seed};
-    stats.seed = seed;
+        std::stringstream value(args[++i]);
+        if (arg == "--trials")
+            value >> options.trials;
+        else if (arg == "--generations")
+            value >> config.generations;
+        else if (arg == "--crossover-prob")
+            value >> config.crossoverProb;
+        else if (arg == "--mutation-prob")
+            value >> config.mutationProb;
+        else if (arg == "--population")
+            value >> config.populationSize;
+        else if (arg == "--elitism")
+            value >> config.elitismCount;
+        else if (arg == "--target-fitness")
+            value >> config.targetFitness;
+        else if (arg == "--stall-generations")
+            value >> config.stallGenerations;
+        else if (arg == "--min-diversity")
+            value >> config.minDiversity;
+        else if (arg == "--adaptive-rates")
+        {
+            if (value.str() == "on")
+                config.adaptiveRates = true;
+            else if (value.str() == "off")
+                config.adaptiveRates = false;
+            else
+                value.setstate(std::ios::failbit);
+        }
+        else if (arg == "--diversity-stats")
+        {
+            if (value.str() == "on")
+                config.diversityStats = true;
+            else if (value.str() == "off")
+                config.diversityStats = false;
+            else
+                value.setstate(std::ios::failbit);
+        }
+        else if (arg == "--selection")
+        {
+            if (value.str() == "roulette")
+                config.selection = SelectionScheme::ROULETTE;
+            else if (value.str() == "tournament")
+                config.selection = SelectionScheme::TOURNAMENT;
+            else if (value.str() == "rank")
+                config.selection = SelectionScheme::RANK;
+            else
+                value.setstate(std::ios::failbit);
+        }
+        else if (arg == "--genome")
+        {
+            if (value.str() == "bitstring")
+                config.genome = GenomeKind::BITSTRING;
+            else if (value.str() == "grid")
+                config.genome = GenomeKind::GRID;
+            else
+                value.setstate(std::ios::failbit);
+        }
+        else if (arg == "--optimizer")
+        {
+            if (value.str() == "ga")
+                config.optimizer = OptimizerKind::GA;
+            else if (value.str() == "de")
+                config.optimizer = OptimizerKind::DIFFERENTIAL_EVOLUTION;
+            else if (value.str() == "sa")
+                config.optimizer = OptimizerKind::SIMULATED_ANNEALING;
+            else if (value.str() == "es")
+                config.optimizer = OptimizerKind::EVOLUTION_STRATEGY;
+            else
+                value.setstate(std::ios::failbit);
+        }
+        else if (arg == "--de-weight")
+            value >> config.deWeight;
+        else if (arg == "--de-crossover-prob")
+            value >> config.deCrossoverProb;
+        else if (arg == "--sa-temperature")
+            value >> config.saTemperature;
+        else if (arg == "--es-offspring")
+            value >> config.esOffspring;
+        else if (arg == "--sbx-index")
+            value >> config.sbxDistributionIndex;
+        else if (arg == "--grid-mutation-prob")
+            value >> config.gridMutationProb;
+        else if (arg == "--grid-mutation-sigma")
+            value >> config.gridMutationSigma;
+        else if (arg == "--crossover")
+        {
+            if (value.str() == "npoint")
+                config.crossover = CrossoverScheme::N_POINT;
+            else if (value.str() == "gene")
+                config.crossover = CrossoverScheme::GENE_ALIGNED;
+            else if (value.str() == "room")
+                config.crossover = CrossoverScheme::ROOM_ALIGNED;
+            else if (value.str() == "uniform")
+                config.crossover = CrossoverScheme::UNIFORM;
+            else
+                value.setstate(std::ios::failbit);
+        }
+        else if (arg == "--crossover-points")
+            value >> config.crossoverPoints;
+        else if (arg == "--encoding")
+        {
+            if (value.str() == "binary")
+                config.encoding = GeneEncoding::BINARY;
+            else if (value.str() == "gray")
+                config.encoding = GeneEncoding::GRAY;
+            else
+                value.setstate(std::ios::failbit);
+        }
+        else if (arg == "--local-search")
+        {
+            if (value.str() == "none")
+                config.localSearch = LocalSearchMode::NONE;
+            else if (value.str() == "lamarckian")
+                config.localSearch = LocalSearchMode::LAMARCKIAN;
+            else if (value.str() == "baldwinian")
+                config.localSearch = LocalSearchMode::BALDWINIAN;
+            else
+                value.setstate(std::ios::failbit);
+        }
+        else if (arg == "--init")
+        {
+            if (value.str() == "rejection")
+                config.initSampling = InitSampling::REJECTION;
+            else if (value.str() == "pool")
+                config.initSampling = InitSampling::POOL;
+            else if (value.str() == "stratified")
+                config.initSampling = InitSampling::STRATIFIED;
+            else
+                value.setstate(std::ios::failbit);
+        }
+        else if (arg == "--local-search-top-k")
+            value >> config.localSearchTopK;
+        else if (arg == "--local-search-budget")
+            value >> config.localSearchBudget;
+        else if (arg == "--tournament-size")
+            value >> config.tournamentSize;
+        else if (arg == "--rank-pressure")
+            value >> config.rankPressure;
+        else if (arg == "--rooms")
+            options.roomSpecFile = value.str();
+        else if (arg == "--sweep")
+            options.sweepFile = value.str();
+        else if (arg == "--threads")
+            value >> options.threads;
+        else if (arg == "--seed")
+        {
+            uint64_t seed = 0;
+            value >> seed;
+            options.masterSeed = seed;
+        }
+        else if (arg == "--replay")
+            options.replayFile = value.str();
+        else if (arg == "--serve")
+            options.serveEndpoint = value.str();
+        else if (arg == "--simd")
+        {
+            if (value.str() == "auto")
+                options.simdLevel.reset();
+            else if (value.str() == "scalar")
+                options.simdLevel = SimdLevel::SCALAR;
+            else if (value.str() == "avx2")
+                options.simdLevel = SimdLevel::AVX2;
+            else if (value.str() == "avx512")
+                options.simdLevel = SimdLevel::AVX512;
+            else
+                value.setstate(std::ios::failbit);
+        }
+        else if (arg == "--lock-step")
+        {
+            if (value.str() == "on")
+                options.lockStep = true;
+            else if (value.str() == "off")
+                options.lockStep = false;
+            else
+                value.setstate(std::ios::failbit);
+        }
+        else if (arg == "--telemetry")
+        {
+            if (value.str() == "on")
+                options.telemetry = true;
+            else if (value.str() == "off")
+                options.telemetry = false;
+            else
+                value.setstate(std::ios::failbit);
+        }
+        else
+        {
+            errors << "Unknown argument " << arg << "\n" << usage;
+            return false;
+        }
 
-    std::cout << "Running GA with seed " << static_cast<unsigned int>(seed) << "...\n";
+        if (value.fail())
+        {
+            errors << "Invalid value for " << arg << "\n" << usage;
+            return false;
+        }
+    }
 
-    Population population;
-    for (int i = 0; i < population.size(); i++)
+    if (options.trials < 1)
     {
-        Individual& individual = population[i];
-        InitializeIndividual(generator, individual);
-        auto roomSet = DecodeChromosome(individual.chromosome);
-        auto result = EvaluateIndividual(roomSet);
-        individual.objective = result.objective;
-        individual.fitness = result.fitness;
+        errors << "--trials must be at least 1\n";
+        return false;
     }
 
-    GenerationStatistics(stats, population, 0);
+    if (config.generations < 0)
+    {
+        errors << "--generations must not be negative\n";
+        return false;
+    }
 
-    for (int gen = 0; gen < NUM_GENERATIONS; gen++)
+    if (config.crossoverProb < 0.0 || config.crossoverProb > 1.0 || config.mutationProb < 0.0 ||
+        config.mutationProb > 1.0)
     {
-        auto cdf = MakeCumulativeProbDist(population);
-        Population newGeneration;
+        errors << "--crossover-prob and --mutation-prob must be in the range [0, 1]\n";
+        return false;
+    }
 
-        for (int i = 0; i < GENERATION_SIZE; i += 2)
-        {
-            auto parents = Select(generator, cdf, population);
+    if (config.populationSize < 2)
+    {
+        errors << "--population must be at least 2\n";
+        return false;
+    }
 
-            // mutation occurs within the Crossover function
-            auto children = Crossover(generator, parents);
-            for (auto& c : children)
-            {
-                auto roomSet = DecodeChromosome(c.chromosome);
-                auto result = EvaluateIndividual(roomSet);
-                c.objective = result.objective;
-                c.fitness = result.fitness;
-            }
+    if (config.elitismCount < 0 || config.elitismCount > config.populationSize)
+    {
+        errors << "--elitism must be in the range [0, " << config.populationSize << "]\n";
+        return false;
+    }
 
-            newGeneration[i] = children[0];
-            newGeneration[i + 1] = children[1];
-        }
+    if (config.crossoverPoints < 1)
+    {
+        errors << "--crossover-points must be at least 1\n";
+        return false;
+    }
 
-        GenerationStatistics(stats, newGeneration, gen + 1);
-        population = newGeneration;
+    if (config.localSearchTopK < 1 || config.localSearchBudget < 1)
+    {
+        errors << "--local-search-top-k and --local-search-budget must be at least 1\n";
+        return false;
     }
 
-    return stats;
-}
+    if (config.localSearch != LocalSearchMode::NONE && SearchesGrid(config))
+    {
+        errors << "--local-search is only supported by the bitstring genome\n";
+        return false;
+    }
 
-void GenerationStatistics(Statistics& stats, const Population& population, int gen)
-{
-    double minFitness = std::numeric_limits<double>::max();
-    double maxFitness = std::numeric_limits<double>::lowest();
-    double sumFitness = 0.0;
+    if (config.optimizer != OptimizerKind::GA &&
+        (config.elitismCount > 0 || config.adaptiveRates || config.diversityStats))
+    {
+        errors << "--elitism, --adaptive-rates and --diversity-stats only apply to --optimizer "
+               << "ga\n";
+        return false;
+    }
 
-    double minObjective = std::numeric_limits<double>::max();
-    double maxObjective = std::numeric_limits<double>::lowest();
-    double sumObjective = 0.0;
+    if (config.optimizer == OptimizerKind::DIFFERENTIAL_EVOLUTION && config.populationSize < 4)
+    {
+        errors << "--optimizer de needs a population of at least 4\n";
+        return false;
+    }
 
-    int fittestIndex = 0;
+    if (config.deWeight <= 0.0 || config.deCrossoverProb < 0.0 || config.deCrossoverProb > 1.0)
+    {
+        errors << "--de-weight must be positive and --de-crossover-prob in the range [0, 1]\n";
+        return false;
+    }
 
-    for (int i = 0; i < population.size(); i++)
+    if (config.saTemperature <= 0.0 || config.esOffspring < 1)
     {
-        if (population[i].objective < minObjective) minObjective = population[i].objective;
-        if (population[i].objective > maxObjective) maxObjective = population[i].objective;
-        sumObjective += population[i].objective;
+        errors << "--sa-temperature must be positive and --es-offspring at least 1\n";
+        return false;
+    }
 
-        if (population[i].fitness < minFitness) minFitness = population[i].fitness;
-        if (population[i].fitness > maxFitness)
-        {
-            maxFitness = population[i].fitness;
-            fittestIndex = i;
-        }
-        sumFitness += population[i].fitness;
+    if (config.tournamentSize < 1)
+    {
+        errors << "--tournament-size must be at least 1\n";
+        return false;
     }
 
-    stats.minObjective[gen] = minObjective;
-    stats.maxObjective[gen] = maxObjective;
-    stats.avgObjective[gen] = sumObjective / population.size();
+    if (config.rankPressure < 1.0 || config.rankPressure > 2.0)
+    {
+        errors << "--rank-pressure must be in the range [1, 2]\n";
+        return false;
+    }
 
-    stats.minFitnesses[gen] = minFitness;
-    stats.maxFitnesses[gen] = maxFitness;
-    stats.avgFitnesses[gen] = sumFitness / population.size();
+    return true;
+}
 
-    stats.fittestIndividuals[gen] = population[fittestIndex];
+// the grid genome and every optimizer but the GA only know the built-in rooms
+bool SearchesGrid(const GAConfig& config)
+{
+    return config.genome == GenomeKind::GRID || config.optimizer != OptimizerKind::GA;
 }
 
-void OutputStatistics(const Statistics& stats, std::ostream& csvSummary, std::ostream& bestText,
-                      const std::string& bestImageFilename)
+bool LoadSpecs(const GAConfig& config, const std::string& roomSpecFile, RoomSpecTable& specs)
 {
-    // prints the statistics in a friendly format
-    // for consumption by a python script
-    csvSummary << std::fixed << std::setprecision(6);
-    csvSummary << "MinFitness,MaxFitness,AvgFitness,MinObjective,MaxObjective,AvgObjective\n";
-    for (int i = 0; i < stats.avgFitnesses.size(); i++)
+    specs = DefaultRoomSpecs();
+    if (roomSpecFile.empty()) return true;
+
+    if (SearchesGrid(config))
     {
-        csvSummary << stats.minFitnesses[i] << ",";
-        csvSummary << stats.maxFitnesses[i] << ",";
-        csvSummary << stats.avgFitnesses[i] << ",";
-        csvSummary << stats.minObjective[i] << ",";
-        csvSummary << stats.maxObjective[i] << ",";
-        csvSummary << stats.avgObjective[i] << "\n";
+        std::cerr << "--rooms is only supported by the bitstring genome\n";
+        return false;
     }
+    return LoadRoomSpecs(roomSpecFile, specs, std::cerr);
+}
 
-    // find the best individual across all generations
-    int fittestOverallIndex = 0;
-    float maxFitness = std::numeric_limits<float>::lowest();
-    for (int i = 0; i < stats.fittestIndividuals.size(); i++)
+// One configuration of a sweep: the command line plus a config line and/or grid point.
+struct SweepConfig
+{
+    std::string description;  // the flags added on top of the command line
+    GAConfig config;
+    RoomSpecTable specs;
+    RoomPools pools;  // shared by every trial of this configuration
+};
+
+struct TrialResult
+{
+    float bestFitness;      // over all generations
+    float finalAvgFitness;  // of the last generation that was run
+    int lastGeneration;
+    double milliseconds;
+    int64_t evaluations;  // GA and local search evaluations, over the whole run
+    int64_t localSearchEvaluations;
+};
+
+// the command line minus the flags that only say which run to reproduce
+std::vector<std::string> ReplayableArgs(const std::vector<std::string>& args)
+{
+    std::vector<std::string> replayable;
+    for (int i = 0; i < args.size(); i += 2)
+    {
+        // --simd and --lock-step don't change the results, the replay may well run on
+        // another CPU
+        if (args[i] == "--seed" || args[i] == "--replay" || args[i] == "--simd" ||
+            args[i] == "--lock-step")
+            continue;
+        replayable.push_back(args[i]);
+        if (i + 1 < args.size()) replayable.push_back(args[i + 1]);
+    }
+    return replayable;
+}
+
+bool ExpandSweep(const std::vector<std::string>& args, const std::string& filename,
+                 std::vector<SweepConfig>& configs)
+{
+    std::ifstream file(filename);
+    if (!file)
     {
-        const Individual& individual = stats.fittestIndividuals[i];
-        if (individual.fitness > maxFitness)
+        std::cerr << "Could not open sweep file " << filename << "\n";
+        return false;
+    }
+
+    std::vector<std::vector<std::string>> bases;
+    std::vector<std::pair<std::string, std::vector<std::string>>> axes;
+
+    std::string line;
+    for (int lineNumber = 1; std::getline(file, line); lineNumber++)
+    {
+        std::stringstream ss(line);
+        std::string kind;
+        if (!(ss >> kind) || kind[0] == '#') continue;
+
+        std::vector<std::string> tokens;
+        for (std::string token; ss >> token;)
+            tokens.push_back(token);
+
+        if (kind == "config")
+            bases.push_back(tokens);
+        else if (kind == "grid" && tokens.size() >= 2)
+            axes.emplace_back(tokens[0],
+                              std::vector<std::string>(tokens.begin() + 1, tokens.end()));
+        else
         {
-            maxFitness = individual.fitness;
-            fittestOverallIndex = i;
+            std::cerr << filename << ":" << lineNumber << ": expected config or grid line\n";
+            return false;
         }
     }
 
-    // print out the best individuals for each generation to a file
-    // and draw out the best individual from the final generation
-    //     TODO: this isn't the best overall one
-    bestText << "==============================================================\n";
-    bestText << "========== SEED FOR THIS TRIAL: " << stats.seed << "\n";
-    bestText << "==============================================================\n\n";
-    
-    for (int i = 0; i < stats.fittestIndividuals.size(); i++)
+    if (bases.empty()) bases.emplace_back();
+
+    // every base times every grid point, the grid index counts like an odometer
+    for (const std::vector<std::string>& base : bases)
     {
-        const Individual& individual = stats.fittestIndividuals[i];
-        auto roomSet = DecodeChromosome(individual.chromosome);
+        std::vector<int> point(axes.size(), 0);
+        do
+        {
+            std::vector<std::string> extra = base;
+            for (int a = 0; a < axes.size(); a++)
+            {
+                extra.push_back(axes[a].first);
+                extra.push_back(axes[a].second[point[a]]);
+            }
 
-        bestText << std::fixed << std::setprecision(6);
-        bestText << "========== BEST INDIVIDUAL OF GENERATION " << i << " ==========\n";
-        bestText << "Fitness..: " << individual.fitness << "\n";
-        bestText << "Objective: " << individual.objective << "\n";
-        PrintChromosome(individual.chromosome, bestText);
-        PrintRoomSet(roomSet, bestText);
-        bestText << "\n";
+            SweepConfig sweepConfig;
+            for (const std::string& token : extra)
+                sweepConfig.description += (sweepConfig.description.empty() ? "" : " ") + token;
+            if (sweepConfig.description.empty()) sweepConfig.description = "(command line)";
 
-        if (i == fittestOverallIndex) DrawRoomSet(roomSet, bestImageFilename);
+            std::vector<std::string> fullArgs = args;
+            fullArgs.insert(fullArgs.end(), extra.begin(), extra.end());
+            RunOptions options;
+            if (!ParseArguments(fullArgs, sweepConfig.config, options) ||
+                !LoadSpecs(sweepConfig.config, options.roomSpecFile, sweepConfig.specs))
+            {
+                std::cerr << "in sweep configuration: " << sweepConfig.description << "\n";
+                return false;
+            }
+            sweepConfig.pools = RoomPools(sweepConfig.specs);
+            configs.push_back(std::move(sweepConfig));
+
+            int a = 0;
+            for (; a < axes.size(); a++)
+            {
+                if (++point[a] < axes[a].second.size()) break;
+                point[a] = 0;
+            }
+            if (a == axes.size()) break;
+        } while (true);
     }
 
-    bestText << "The fittest individual across all generations occurred in generation "
-             << fittestOverallIndex << "\n";
+    return true;
 }
 
-float GenerateFloatInRange(std::mt19937& generator, const Range<float> range)
+bool RunSweep(const std::vector<std::string>& args, const RunOptions& options,
+              TelemetryRing& telemetry)
 {
-    // since we are dealing with discrete float values,
-    // we want to generate them as a discrete type first
-    constexpr float offset = 10.0f;
-    std::uniform_int_distribution<int> dist(range.low * offset, range.high * offset);
-    int value = dist(generator);
-    return value / offset;
+    std::vector<SweepConfig> configs;
+    if (!ExpandSweep(args, options.sweepFile, configs)) return false;
+
+    const int threads =
+        options.threads > 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "Sweeping " << configs.size() << " configurations x " << options.trials
+              << " trials on " << threads << " threads...\n";
+
+    // seeds are derived up front so the jobs share nothing but their own result slot
+    std::vector<std::vector<TrialResult>> results(configs.size());
+    std::vector<WorkStealingPool::Job> jobs;
+    for (int c = 0; c < configs.size(); c++)
+    {
+        results[c].resize(options.trials);
+        for (int t = 0; t < options.trials; t++)
+        {
+            const std::random_device::result_type seed =
+                DeriveTrialSeed(*options.masterSeed, c * options.trials + t);
+            jobs.push_back([&, c, t, seed] {
+                TelemetryRing* ring = telemetry.IsOpen() ? &telemetry : nullptr;
+                ThreadTelemetry() =
+                    TelemetryChannel{ring, static_cast<uint32_t>(c), static_cast<uint32_t>(t)};
+
+                auto start = std::chrono::steady_clock::now();
+                Statistics stats = RunGeneticAlgorithm(configs[c].config, configs[c].specs,
+                                                       configs[c].pools, seed);
+                auto end = std::chrono::steady_clock::now();
+                if (ring != nullptr) ring->FinishTrial();
+
+                TrialResult& result = results[c][t];
+                result.bestFitness =
+                    *std::max_element(stats.maxFitnesses.begin(), stats.maxFitnesses.end());
+                result.finalAvgFitness = stats.avgFitnesses[stats.lastGeneration];
+                result.lastGeneration = stats.lastGeneration;
+                result.milliseconds =
+                    std::chrono::duration<double, std::milli>(end - start).count();
+                result.evaluations = stats.evaluations[stats.lastGeneration];
+                result.localSearchEvaluations = stats.localSearchEvaluations[stats.lastGeneration];
+            });
+        }
+    }
+
+    if (telemetry.IsOpen()) telemetry.AddTrials(jobs.size());
+    WorkStealingPool pool(threads);
+    auto start = std::chrono::steady_clock::now();
+    pool.Run(std::move(jobs));
+    auto end = std::chrono::steady_clock::now();
+
+    std::ofstream table("data/sweep-results.csv");
+    table << std::fixed << std::setprecision(6);
+    table << "Config,Description,Trials,MeanBestFitness,StdBestFitness,MaxBestFitness,"
+          << "MeanFinalAvgFitness,MeanGenerations,MeanTrialMs,TotalTrialMs,MeanEvaluations,"
+          << "MeanLocalSearchEvaluations\n";
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Config  MeanBest   StdBest   MaxBest  FinalAvg  MeanGens   TrialMs  "
+              << "Description\n";
+    for (int c = 0; c < configs.size(); c++)
+    {
+        double sumBest = 0.0, sumSquaredBest = 0.0, maxBest = 0.0;
+        double sumFinalAvg = 0.0, sumGenerations = 0.0, sumMilliseconds = 0.0;
+        double sumEvaluations = 0.0, sumLocalSearchEvaluations = 0.0;
+        for (const TrialResult& result : results[c])
+        {
+            sumBest += result.bestFitness;
+            sumSquaredBest += result.bestFitness * result.bestFitness;
+            maxBest = std::max(maxBest, static_cast<double>(result.bestFitness));
+            sumFinalAvg += result.finalAvgFitness;
+            sumGenerations += result.lastGeneration;
+            sumMilliseconds += result.milliseconds;
+            sumEvaluations += result.evaluations;
+            sumLocalSearchEvaluations += result.localSearchEvaluations;
+        }
+
+        const double n = results[c].size();
+        const double meanBest = sumBest / n;
+        const double stdBest = std::sqrt(std::max(0.0, sumSquaredBest / n - meanBest * meanBest));
+
+        table << c << ",\"" << configs[c].description << "\"," << results[c].size() << ","
+              << meanBest << "," << stdBest << "," << maxBest << "," << sumFinalAvg / n << ","
+              << sumGenerations / n << "," << sumMilliseconds / n << "," << sumMilliseconds << ","
+              << sumEvaluations / n << "," << sumLocalSearchEvaluations / n << "\n";
+
+        std::cout << std::setw(6) << c << std::setw(10) << meanBest << std::setw(10) << stdBest
+                  << std::setw(10) << maxBest << std::setw(10) << sumFinalAvg / n << std::setw(10)
+                  << sumGenerations / n << std::setw(10) << sumMilliseconds / n << "  "
+                  << configs[c].description << "\n";
+    }
+
+    std::cout << "Sweep took " << std::chrono::duration<double>(end - start).count() << " s ("
+              << pool.StolenJobs() << " jobs stolen), results in data/sweep-results.csv\n";
+    return true;
 }
 
-void InitializeIndividual(std::mt19937& generator, Individual& x)
+// A spec table and its pools, shared by every daemon job that sends the same rooms.
+struct SpecTables
 {
-    constexpr Range<float> defaultRange(0.0f, 102.3f);
+    RoomSpecTable specs;
+    RoomPools pools;
+};
 
-    RoomSet roomSet;
+class SpecTableCache
+{
+public:
+    static constexpr std::size_t CAPACITY = 64;  // distinct room lists kept warm
 
-    // initialize each room with valid values
-    // Living, Kitchen, Bath, Hall, Bed1, Bed2, Bed3
-    roomSet[0].type = RoomType::LIVING;
-    do
+    // the tables for a job's room lines, the built-in rooms if there are none
+    std::shared_ptr<const SpecTables> Get(const std::vector<std::string>& rooms,
+                                          std::ostream& errors)
     {
-        // fixed proportions must be generated in a different way
-        // this prevents us from spinning our wheels in this loop for a Very Long Time
-        float tmpLength = GenerateFloatInRange(generator, LIVING_LENGTH);
-        float tmpWidth = GenerateFloatInRange(generator, LIVING_WIDTH);
-        float propLength = LIVING_PROPORTION * tmpWidth;
-        float propWidth = LIVING_PROPORTION * tmpLength;
+        std::string text;
+        for (const std::string& line : rooms)
+            text += line + "\n";
 
-        // the selection process is biased towards longer width, but whatever
-        if (LIVING_LENGTH.Contains(tmpLength) && LIVING_WIDTH.Contains(propWidth))
         {
-            roomSet[0].length = tmpLength;
-            roomSet[0].width = propWidth;
+            std::lock_guard lock(mutex_);
+            const auto found = tables_.find(text);
+            if (found != tables_.end()) return found->second;
         }
-        else if (LIVING_LENGTH.Contains(propLength) && LIVING_WIDTH.Contains(tmpWidth))
+
+        // built outside the lock, two jobs racing on new rooms just both build them
+        auto tables = std::make_shared<SpecTables>();
+        tables->specs = DefaultRoomSpecs();
+        std::istringstream stream(text);
+        if (!rooms.empty() && !ReadRoomSpecs(stream, "rooms", tables->specs, errors))
+            return nullptr;
+        tables->pools = RoomPools(tables->specs);
+
+        std::lock_guard lock(mutex_);
+        if (tables_.size() >= CAPACITY) tables_.clear();
+        return tables_.emplace(text, std::move(tables)).first->second;
+    }
+
+private:
+    std::mutex mutex_;
+    std::map<std::string, std::shared_ptr<const SpecTables>> tables_;
+};
+
+// Runs one daemon job and streams its results, one JSON line per event:
+//   started     the master seed and number of trials
+//   generation  best and average fitness of every generation of every trial
+//   trial       how a trial ended and its fittest layout
+//   done        the job's wall time
+//   error       the job was rejected, nothing else follows
+void RunDaemonJob(const DaemonJob& job, DaemonClient& client, SpecTableCache& cache,
+                  TelemetryRing* ring)
+{
+    const auto start = std::chrono::steady_clock::now();
+    auto respond = [&](std::string_view event, const std::string& fields) {
+        client.WriteLine("{\"id\":" + job.id + ",\"event\":\"" + std::string(event) + "\"" +
+                         fields + "}");
+    };
+
+    GAConfig config;
+    RunOptions options;
+    std::ostringstream errors;
+    std::shared_ptr<const SpecTables> tables;
+    if (ParseArguments(job.args, config, options, errors))
+    {
+        if (!options.roomSpecFile.empty() || !options.sweepFile.empty() ||
+            !options.replayFile.empty() || !options.serveEndpoint.empty())
+            errors << "--rooms, --sweep, --replay and --serve can't be used in a job "
+                   << "(send the room lines as rooms instead)\n";
+        else if (!job.rooms.empty() && SearchesGrid(config))
+            errors << "rooms are only supported by the bitstring genome\n";
+        else
+            tables = cache.Get(job.rooms, errors);
+    }
+    if (tables == nullptr)
+    {
+        // the first line says what's wrong, the rest is the usage text
+        const std::string message = errors.str();
+        respond("error", ",\"message\":" + JsonString(message.substr(0, message.find('\n'))));
+        return;
+    }
+
+    uint64_t masterSeed = job.seed.value_or(options.masterSeed.value_or(0));
+    if (!job.seed && !options.masterSeed)
+    {
+        std::random_device device{};
+        masterSeed = uint64_t{device()} << 32 | device();
+    }
+    respond("started", ",\"seed\":" + std::to_string(masterSeed) +
+                           ",\"trials\":" + std::to_string(options.trials));
+    if (ring != nullptr) ring->AddTrials(options.trials);
+
+    for (int t = 0; t < options.trials; t++)
+    {
+        const std::string trialField = ",\"trial\":" + std::to_string(t);
+        TelemetryChannel& telemetry = ThreadTelemetry();
+        telemetry = TelemetryChannel{ring, job.number, static_cast<uint32_t>(t)};
+        telemetry.listener = [&](const TelemetrySample& sample) {
+            respond("generation", trialField +
+                                      ",\"generation\":" + std::to_string(sample.generation) +
+                                      ",\"bestFitness\":" + JsonNumber(sample.bestFitness) +
+                                      ",\"avgFitness\":" + JsonNumber(sample.avgFitness));
+        };
+
+        const auto trialStart = std::chrono::steady_clock::now();
+        const Statistics stats = RunGeneticAlgorithm(config, tables->specs, tables->pools,
+                                                     DeriveTrialSeed(masterSeed, t));
+        const auto trialEnd = std::chrono::steady_clock::now();
+        telemetry = TelemetryChannel{};
+        if (ring != nullptr) ring->FinishTrial();
+
+        const FittestIndividual fittest =
+            stats.fittest.At(stats.fittest.FittestGeneration(stats.lastGeneration));
+
+        std::string rooms;
+        for (int r = 0; r < fittest.rooms.size(); r++)
         {
-            roomSet[0].length = propLength;
-            roomSet[0].width = propWidth;
+            rooms += (r == 0 ? "{\"name\":" : ",{\"name\":") +
+                     JsonString(tables->specs[r].name) + ",\"length\":" +
+                     JsonNumber(PackedRoomLength(fittest.rooms[r]) / 10.0) + ",\"width\":" +
+                     JsonNumber(PackedRoomWidth(fittest.rooms[r]) / 10.0) + "}";
         }
-    } while (!DoesRoomFitConstraints(roomSet[0]));
 
-    roomSet[1].type = RoomType::KITCHEN;
-    do
+        respond("trial",
+                trialField + ",\"lastGeneration\":" + std::to_string(stats.lastGeneration) +
+                    ",\"stopReason\":" + JsonString(StopReasonToString(stats.stopReason)) +
+                    ",\"evaluations\":" +
+                    std::to_string(stats.evaluations[stats.lastGeneration] +
+                                   stats.localSearchEvaluations[stats.lastGeneration]) +
+                    ",\"milliseconds\":" +
+                    JsonNumber(
+                        std::chrono::duration<double, std::milli>(trialEnd - trialStart).count()) +
+                    ",\"bestFitness\":" + JsonNumber(fittest.fitness) +
+                    ",\"bestObjective\":" + JsonNumber(fittest.objective) + ",\"rooms\":[" +
+                    rooms + "]");
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+    respond("done",
+            ",\"milliseconds\":" +
+                JsonNumber(std::chrono::duration<double, std::milli>(end - start).count()));
+}
+
+bool RunDaemon(const std::vector<std::string>& args, const RunOptions& options)
+{
+    for (int i = 0; i < args.size(); i += 2)
     {
-        roomSet[1].length = GenerateFloatInRange(generator, KITCHEN_LENGTH);
-        roomSet[1].width = GenerateFloatInRange(generator, KITCHEN_WIDTH);
-    } while (!DoesRoomFitConstraints(roomSet[1]));
+        if (args[i] != "--serve" && args[i] != "--threads" && args[i] != "--telemetry" &&
+            args[i] != "--simd")
+        {
+            std::cerr << "--serve only takes --threads, --telemetry and --simd, every other "
+                      << "setting comes with the jobs\n";
+            return false;
+        }
+    }
 
-    roomSet[2].type = RoomType::BATH;
-    roomSet[2].length = BATH_LENGTH;
-    roomSet[2].width = BATH_WIDTH;
+    // stdout may be the response stream, so everything else goes to stderr
+    TelemetryRing telemetry;
+    if (options.telemetry && telemetry.Create())
+        std::cerr << "Live progress: as3-top " << telemetry.OwnerPid() << "\n";
+    TelemetryRing* ring = telemetry.IsOpen() ? &telemetry : nullptr;
+
+    const int threads =
+        options.threads > 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    SpecTableCache cache;
+    cache.Get({}, std::cerr);  // warm the built-in rooms before the first job
+
+    const std::string& endpoint = options.serveEndpoint;
+    std::cerr << "Serving jobs on " << (endpoint == "-" ? "stdin" : endpoint) << " with "
+              << threads << " worker thread(s) and " << SimdLevelToString(Kernels().level)
+              << " kernels\n";
+    return ServeJobs(endpoint, threads, [&](const DaemonJob& job, DaemonClient& client) {
+        RunDaemonJob(job, client, cache, ring);
+    });
+}
 
-    roomSet[3].type = RoomType::HALL;
-    do
+// Runs the GA's trials in lock step, any other optimizer's one after another.
+template <StatisticsOptimizer Optimizer>
+std::vector<Statistics> RunEngine(Optimizer& optimizer, TrialSeeds seeds)
+{
+    if constexpr (requires { optimizer.RunLockStep(seeds); })
     {
-        roomSet[3].length = HALL_LENGTH;
-        roomSet[3].width = GenerateFloatInRange(generator, HALL_WIDTH);
-    } while (!DoesRoomFitConstraints(roomSet[3]));
+        if (seeds.size() > 1) return optimizer.RunLockStep(seeds);
+    }
 
-    roomSet[4].type = RoomType::BED1;
-    do
+    // numbered like RunLockStep's trials
+    const TelemetryChannel channel = ThreadTelemetry();
+    std::vector<Statistics> results;
+    for (int i = 0; i < seeds.size(); i++)
     {
-        float tmpLength = GenerateFloatInRange(generator, BED1_LENGTH);
-        float tmpWidth = GenerateFloatInRange(generator, BED1_WIDTH);
-        float propLength = BED1_PROPORTION * tmpWidth;
-        float propWidth = BED1_PROPORTION * tmpLength;
+        ThreadTelemetry().trial = channel.trial + i;
+        results.push_back(optimizer.Run(seeds[i]));
+    }
+    ThreadTelemetry() = channel;
+    return results;
+}
 
-        roomSet[4].length = GenerateFloatInRange(generator, BED1_LENGTH);
-        roomSet[4].width = GenerateFloatInRange(generator, BED1_WIDTH);
+Statistics RunGeneticAlgorithm(const GAConfig& config, const RoomSpecTable& specs,
+                               const RoomPools& pools, std::random_device::result_type seed)
+{
+    return RunTrials(config, specs, pools, TrialSeeds(&seed, 1))[0];
+}
 
-        if (BED1_LENGTH.Contains(tmpLength) && BED1_WIDTH.Contains(propWidth))
+// One trial per seed, in lock step when there is more than one (see RunLockStep).
+std::vector<Statistics> RunTrials(const GAConfig& config, const RoomSpecTable& specs,
+                                  const RoomPools& pools, TrialSeeds seeds)
+{
+    switch (config.optimizer)
+    {
+        case OptimizerKind::DIFFERENTIAL_EVOLUTION:
         {
-            roomSet[4].length = tmpLength;
-            roomSet[4].width = propWidth;
+            DifferentialEvolution<> de(config);
+            return RunEngine(de, seeds);
         }
-        else if (BED1_LENGTH.Contains(propLength) && BED1_WIDTH.Contains(tmpWidth))
+        case OptimizerKind::SIMULATED_ANNEALING:
         {
-            roomSet[4].length = propLength;
-            roomSet[4].width = propWidth;
+            SimulatedAnnealing<> sa(config);
+            return RunEngine(sa, seeds);
         }
-    } while (!DoesRoomFitConstraints(roomSet[4]));
+        case OptimizerKind::EVOLUTION_STRATEGY:
+        {
+            EvolutionStrategy<> es(config);
+            return RunEngine(es, seeds);
+        }
+        case OptimizerKind::GA:
+        default:
+            break;
+    }
 
-    roomSet[5].type = RoomType::BED2;
-    do
+    if (config.genome == GenomeKind::GRID)
     {
-        float tmpLength = GenerateFloatInRange(generator, BED2_LENGTH);
-        float tmpWidth = GenerateFloatInRange(generator, BED2_WIDTH);
-        float propLength = BED2_PROPORTION * tmpWidth;
-        float propWidth = BED2_PROPORTION * tmpLength;
+        SimulatedBinaryCrossover crossover{config.crossoverProb, config.sbxDistributionIndex};
+        GaussianMutation mutation{config.gridMutationProb, config.gridMutationSigma};
+        return RunTrials(config, GridGenome{}, crossover, mutation, GridEvaluator{}, seeds);
+    }
+
+    if (config.encoding == GeneEncoding::GRAY)
+        return RunTrials<GeneEncoding::GRAY>(config, specs, pools, seeds);
+    return RunTrials<GeneEncoding::BINARY>(config, specs, pools, seeds);
+}
 
-        roomSet[5].length = GenerateFloatInRange(generator, BED2_LENGTH);
-        roomSet[5].width = GenerateFloatInRange(generator, BED2_WIDTH);
+template <GeneEncoding Encoding>
+std::vector<Statistics> RunTrials(const GAConfig& config, const RoomSpecTable& specs,
+                                  const RoomPools& pools, TrialSeeds seeds)
+{
+    // the spec genome handles the built-in seven rooms and loaded room tables alike
+    SpecGenome<Encoding> genome{&specs, &pools, config.initSampling};
+    SpecEvaluator<Encoding> evaluator{&specs, GetSpecCostRange(specs)};
+    PackedBitFlipMutation mutation{config.mutationProb};
 
-        if (BED2_LENGTH.Contains(tmpLength) && BED2_WIDTH.Contains(propWidth))
+    switch (config.crossover)
+    {
+        case CrossoverScheme::GENE_ALIGNED:
         {
-            roomSet[5].length = tmpLength;
-            roomSet[5].width = propWidth;
+            MaskCrossover<GeneNPointMask> crossover{config.crossoverProb, {config.crossoverPoints}};
+            return RunTrials(config, genome, crossover, mutation, evaluator, seeds);
         }
-        else if (BED2_LENGTH.Contains(propLength) && BED2_WIDTH.Contains(tmpWidth))
+        case CrossoverScheme::ROOM_ALIGNED:
         {
-            roomSet[5].length = propLength;
-            roomSet[5].width = propWidth;
+            MaskCrossover<RoomNPointMask> crossover{config.crossoverProb, {config.crossoverPoints}};
+            return RunTrials(config, genome, crossover, mutation, evaluator, seeds);
         }
-    } while (!DoesRoomFitConstraints(roomSet[5]));
-
-    roomSet[6].type = RoomType::BED3;
-    do
-    {
-        float tmpLength = GenerateFloatInRange(generator, BED3_LENGTH);
-        float tmpWidth = GenerateFloatInRange(generator, BED3_WIDTH);
-        float propLength = BED3_PROPORTION * tmpWidth;
-        float propWidth = BED3_PROPORTION * tmpLength;
+        case CrossoverScheme::UNIFORM:
+        {
+            MaskCrossover<UniformMask> crossover{config.crossoverProb, {}};
+            return RunTrials(config, genome, crossover, mutation, evaluator, seeds);
+        }
+        case CrossoverScheme::N_POINT:
+        default:
+        {
+            MaskCrossover<BitNPointMask> crossover{config.crossoverProb, {config.crossoverPoints}};
+            return RunTrials(config, genome, crossover, mutation, evaluator, seeds);
+        }
+    }
+}
 
-        roomSet[6].length = GenerateFloatInRange(generator, BED3_LENGTH);
-        roomSet[6].width = GenerateFloatInRange(generator, BED3_WIDTH);
 
-        if (BED3_LENGTH.Contains(tmpLength) && BED3_WIDTH.Contains(propWidth))
+template <typename Genome, typename Crossover, typename Mutation, typename Evaluator>
+std::vector<Statistics> RunTrials(const GAConfig& config, Genome genome, Crossover crossover,
+                                  Mutation mutation, Evaluator evaluator, TrialSeeds seeds)
+{
+    // each selection scheme gets its own fully specialized engine
+    switch (config.selection)
+    {
+        case SelectionScheme::TOURNAMENT:
+        {
+            TournamentSelection selection{config.tournamentSize};
+            GeneticAlgorithm<Genome, TournamentSelection, Crossover, Mutation, Evaluator> ga(
+                config, selection, crossover, mutation, evaluator, genome);
+            return RunEngine(ga, seeds);
+        }
+        case SelectionScheme::RANK:
         {
-            roomSet[6].length = tmpLength;
-            roomSet[6].width = propWidth;
+            RankSelection selection{config.rankPressure};
+            GeneticAlgorithm<Genome, RankSelection, Crossover, Mutation, Evaluator> ga(
+                config, selection, crossover, mutation, evaluator, genome);
+            return RunEngine(ga, seeds);
         }
-        else if (BED3_LENGTH.Contains(propLength) && BED3_WIDTH.Contains(tmpWidth))
+        case SelectionScheme::ROULETTE:
+        default:
         {
-            roomSet[6].length = propLength;
-            roomSet[6].width = propWidth;
+            GeneticAlgorithm<Genome, RouletteSelection, Crossover, Mutation, Evaluator> ga(
+                config, RouletteSelection{}, crossover, mutation, evaluator, genome);
+            return RunEngine(ga, seeds);
         }
-    } while (!DoesRoomFitConstraints(roomSet[6]));
+    }
+}
+
+// One row per generation: mean pairwise Hamming distance (in bits and as a fraction of the
+// chromosome), unique genomes, then the frequency of every allele, e.g. "Bath.W3" is bit 3
+// of the bath's width.
+void OutputDiversity(const Statistics& stats, const RoomSpecTable& specs, std::ostream& csv)
+{
+    constexpr std::array<char, 4> fields = {'L', 'W', 'X', 'Y'};
+
+    csv << std::fixed << std::setprecision(6);
+    csv << "MeanHamming,NormalizedHamming,UniqueGenomes";
+    for (const RoomSpec& spec : specs)
+        for (char field : fields)
+            for (int bit = FLOAT_BITWIDTH - 1; bit >= 0; bit--)
+                csv << "," << spec.name << "." << field << bit;
+    csv << "\n";
+
+    for (int i = 0; i <= stats.lastGeneration; i++)
+    {
+        const DiversityStatistics& diversity = stats.diversity[i];
+        csv << diversity.meanHamming << ","
+            << diversity.meanHamming / diversity.alleleFrequencies.size() << ","
+            << diversity.uniqueGenomes;
+        for (float frequency : diversity.alleleFrequencies)
+            csv << "," << frequency;
+        csv << "\n";
+    }
+}
 
-    // we actually don't care about position at all
-    // so let's just generate one randomly and call it a day
-    // (because I don't want to re-write my encoders/decoders)
-    for (Room& room : roomSet)
+void OutputStatistics(const Statistics& stats, const RoomSpecTable& specs,
+                      std::ostream& csvSummary, std::ostream& bestText,
+                      const std::string& bestImageFilename)
+{
+    // prints the statistics in a friendly format
+    // for consumption by a python script
+    csvSummary << std::fixed << std::setprecision(6);
+    csvSummary << "MinFitness,MaxFitness,AvgFitness,MinObjective,MaxObjective,AvgObjective,"
+               << "Evaluations,LocalSearchEvaluations,MutationRate,CrossoverRate\n";
+    for (int i = 0; i <= stats.lastGeneration; i++)
     {
-        room.x = GenerateFloatInRange(generator, defaultRange);
-        room.y = GenerateFloatInRange(generator, defaultRange);
+        csvSummary << stats.minFitnesses[i] << ",";
+        csvSummary << stats.maxFitnesses[i] << ",";
+        csvSummary << stats.avgFitnesses[i] << ",";
+        csvSummary << stats.minObjective[i] << ",";
+        csvSummary << stats.maxObjective[i] << ",";
+        csvSummary << stats.avgObjective[i] << ",";
+        csvSummary << stats.evaluations[i] << ",";
+        csvSummary << stats.localSearchEvaluations[i] << ",";
+        csvSummary << stats.mutationRates[i] << ",";
+        csvSummary << stats.crossoverRates[i] << "\n";
     }
 
-    x.chromosome = EncodeChromosome(roomSet);
+    // find the best individual across all generations
+    const int fittestOverallIndex = stats.fittest.FittestGeneration(stats.lastGeneration);
+
+    // print out the best individual of each generation it changed in to a file
+    // and draw out the best one overall
+    bestText << "==============================================================\n";
+    bestText << "========== SEED FOR THIS TRIAL: " << stats.seed << "\n";
+    bestText << "========== STOPPED AFTER GENERATION " << stats.lastGeneration << " ("
+             << StopReasonToString(stats.stopReason) << ")\n";
+    bestText << "========== GENERATIONS NOT LISTED KEPT THE BEST BEFORE THEM\n";
+    bestText << "==============================================================\n\n";
+
+    stats.fittest.ForEachChange(stats.lastGeneration, [&](int i,
+                                                          const FittestIndividual& individual) {
+        bestText << std::fixed << std::setprecision(6);
+        bestText << "========== BEST INDIVIDUAL OF GENERATION " << i << " ==========\n";
+        bestText << "Fitness..: " << individual.fitness << "\n";
+        bestText << "Objective: " << individual.objective << "\n";
+        PrintPackedRooms(individual.rooms, specs, bestText);
+        PrintSpecRoomSet(individual.rooms, specs, bestText);
+        bestText << "\n";
+
+        if (i == fittestOverallIndex) DrawRooms(individual.rooms, specs, bestImageFilename);
+    });
+
+    bestText << "The fittest individual across all generations occurred in generation "
+             << fittestOverallIndex << "\n";
 }
 
-void DrawRoomSet(const RoomSet& roomSet, const std::string& filename)
+void DrawRooms(const std::vector<uint64_t>& rooms, const RoomSpecTable& specs,
+               const std::string& filename)
 {
     if (filename == "") return;
 
@@ -461,7 +1323,7 @@ void DrawRoomSet(const RoomSet& roomSet, const std::string& filename)
     static constexpr std::array<uint8_t, 3> borderColor{255, 255, 255};
     static constexpr std::array<uint8_t, 3> invalidColor{191, 191, 191};
 
-    // default matplotlib color cycle
+    // default matplotlib color cycle, repeated for buildings with more than seven rooms
     // ['#1f77b4', '#ff7f0e', '#2ca02c', '#d62728', '#9467bd', '#8c564b', '#e377c2']
     static constexpr std::array<uint8_t, 3> livingColor{0x1f, 0x77, 0xb4};
     static constexpr std::array<uint8_t, 3> kitchenColor{0xff, 0x7f, 0x0e};
@@ -473,22 +1335,28 @@ void DrawRoomSet(const RoomSet& roomSet, const std::string& filename)
     static constexpr std::array roomColors = {livingColor, kitchenColor, bathColor, hallColor,
                                               bed1Color,   bed2Color,    bed3Color};
 
-    // maximum possible room length and width is both 20.0f units
+    // every square fits the largest room the specs allow (20.0f units for the default rooms)
     // which is 200px at a precision of 0.1f
-    constexpr int squareLength = 200;
+    int squareLength = 0;
+    for (const RoomSpec& spec : specs)
+        squareLength = std::max({squareLength, spec.length.high, spec.width.high});
     constexpr int paddingPixels = 10;
     constexpr int checkerSize = 5;
 
-    // image will be a 4x2 grid of squares used to visualize room areas
-    constexpr int imageLength = (5 * paddingPixels) + (4 * squareLength);
-    constexpr int imageWidth = (3 * paddingPixels) + (2 * squareLength);
-
-    std::array<int, NUM_ROOMS> roomOffsetX;
-    std::array<int, NUM_ROOMS> roomOffsetY;
-    for (int i = 0; i < NUM_ROOMS; i++)
+    // image will be a grid of squares used to visualize room areas
+    // at least 4 columns (4x2 for the default rooms), growing towards a square grid
+    const int numRooms = static_cast<int>(rooms.size());
+    const int columns = std::max(4, static_cast<int>(std::ceil(std::sqrt(numRooms))));
+    const int rows = (numRooms + columns - 1) / columns;
+    const int imageLength = ((columns + 1) * paddingPixels) + (columns * squareLength);
+    const int imageWidth = ((rows + 1) * paddingPixels) + (rows * squareLength);
+
+    std::vector<int> roomOffsetX(numRooms);
+    std::vector<int> roomOffsetY(numRooms);
+    for (int i = 0; i < numRooms; i++)
     {
-        const int col = i % 4;
-        const int row = i / 4;
+        const int col = i % columns;
+        const int row = i / columns;
         roomOffsetX[i] = paddingPixels + (col * (squareLength + paddingPixels));
         roomOffsetY[i] = paddingPixels + (row * (squareLength + paddingPixels));
     }
@@ -499,9 +1367,12 @@ void DrawRoomSet(const RoomSet& roomSet, const std::string& filename)
     // |
     // V 1023 (width)
     cimg_library::CImg<uint8_t> image(imageLength, imageWidth, 1, 3, backgroundColor);
-    for (int i = 0; i < NUM_ROOMS; i++)
+    for (int i = 0; i < numRooms; i++)
     {
-        const Room& room = roomSet[i];
+        const int length = PackedRoomLength(rooms[i]);
+        const int width = PackedRoomWidth(rooms[i]);
+        const bool valid = DoesRoomFitSpec(specs[i], length, width);
+        const std::array<uint8_t, 3>& roomColor = roomColors[i % roomColors.size()];
 
         // draw the frames that the rooms will inhabit
         for (int x = roomOffsetX[i]; x < roomOffsetX[i] + squareLength; x++)
@@ -526,9 +1397,6 @@ void DrawRoomSet(const RoomSet& roomSet, const std::string& filename)
             image(roomOffsetX[i] + squareLength, y, 0, 2) = borderColor[2];
         }
 
-        const int length = static_cast<int>(room.length * 10.0f);
-        const int width = static_cast<int>(room.width * 10.0f);
-
         int xMax = roomOffsetX[i] + length;
         xMax = xMax < imageLength ? xMax : imageLength;
         int yMax = roomOffsetY[i] + width;
@@ -539,11 +1407,11 @@ void DrawRoomSet(const RoomSet& roomSet, const std::string& filename)
         {
             for (int y = roomOffsetY[i]; y < yMax; y++)
             {
-                if (DoesRoomFitConstraints(room))
+                if (valid)
                 {
-                    image(x, y, 0, 0) = roomColors[i][0];
-                    image(x, y, 0, 1) = roomColors[i][1];
-                    image(x, y, 0, 2) = roomColors[i][2];
+                    image(x, y, 0, 0) = roomColor[0];
+                    image(x, y, 0, 1) = roomColor[1];
+                    image(x, y, 0, 2) = roomColor[2];
                 }
                 else
                 {
@@ -569,127 +1437,3 @@ void DrawRoomSet(const RoomSet& roomSet, const std::string& filename)
     }
     image.save_png(filename.c_str());
 }
-
-EvaluationResult EvaluateIndividual(const RoomSet& rooms)
-{
-    // a further modification is needed here
-    // invalid rooms should be assessed on an individual basis
-    // e.g a layout with one invalid room should be more fit than one with five invalid rooms
-    // an invalid room with have an objective value of ${ROOM}_AREA.high
-    // (the maximum area and thus maximum cost)
-
-    float objective = 0.0f;
-    for (int i = 0; i < NUM_ROOMS; i++)
-    {
-        const Room& room = rooms[i];
-        objective += DoesRoomFitConstraints(room) ? RoomCost(room) : INVALID_OBJECTIVE[i];
-    }
-    float fitness = ObjectiveToFitness(objective);
-
-    EvaluationResult ret;
-    ret.objective = objective;
-    ret.fitness = fitness;
-    return ret;
-}
-
-ProbDist MakeCumulativeProbDist(const Population& pop)
-{
-    double totalFitness = 0.0;
-    for (const Individual& indiv : pop)
-        totalFitness += indiv.fitness;
-    ProbDist cumulativeProbs;
-
-    // if the total fitness is 0, the entire probability distribution will be 0s
-    // to prevent this, we instead return a uniform CDF.
-    if (totalFitness == 0.0f)
-    {
-        float accumulator = 0.1f;
-        for (int i = 0; i < cumulativeProbs.size(); i++)
-        {
-            cumulativeProbs[i] = accumulator;
-            accumulator += 0.1f;
-        }
-        return cumulativeProbs;
-    }
-
-    // ProbDist fitnessProportions;  // for debugging
-    // ProbDist expectedValues;      // for debugging
-    double accumulator = 0.0;
-
-    for (int i = 0; i < GENERATION_SIZE; i++)
-    {
-        const double fitnessProportion = pop[i].fitness / totalFitness;
-        accumulator += fitnessProportion;
-        cumulativeProbs[i] = accumulator;
-
-        // for debugging
-        // double expectedValue = fitnessProportion * GENERATION_SIZE;
-        // expectedValues[i] = expectedValue;
-        // fitnessProportions[i] = fitnessProportion;
-    }
-
-    return cumulativeProbs;
-}
-
-std::array<Individual, 2> Select(std::mt19937& generator, const ProbDist& cdf, const Population& pop)
-{
-    std::array<Individual, 2> parents;
-    std::uniform_real_distribution<double> dist(0.0, 1.0);
-
-    for (int i = 0; i < 2; i++)
-    {
-        double prob = dist(generator);
-        for (int j = 0; j < GENERATION_SIZE; j++)
-        {
-            if (prob <= cdf[j])
-            {
-                parents[i] = pop[j];
-                break;
-            }
-        }
-    }
-
-    return parents;
-}
-
-std::array<Individual, 2> Crossover(std::mt19937& generator, const std::array<Individual, 2>& parents)
-{
-    std::array<Individual, 2> children;
-    std::uniform_real_distribution<double> dist(0.0, 1.0);
-
-    double prob = dist(generator);
-    if (prob <= CROSSOVER_PROB)
-    {
-        std::uniform_int_distribution<int> distInt(0, CHROMOSOME_BITWIDTH - 1);
-        int crossoverIndex = distInt(generator);
-
-        for (int i = 0; i < crossoverIndex; i++)
-        {
-            children[0].chromosome[i] = MutateBit(generator, parents[0].chromosome[i]);
-            children[1].chromosome[i] = MutateBit(generator, parents[1].chromosome[i]);
-        }
-        for (int i = crossoverIndex; i < CHROMOSOME_BITWIDTH; i++)
-        {
-            children[0].chromosome[i] = MutateBit(generator, parents[1].chromosome[i]);
-            children[1].chromosome[i] = MutateBit(generator, parents[0].chromosome[i]);
-        }
-    }
-    else
-    {
-        for (int i = 0; i < CHROMOSOME_BITWIDTH; i++)
-        {
-            children[0].chromosome[i] = MutateBit(generator, parents[0].chromosome[i]);
-            children[1].chromosome[i] = MutateBit(generator, parents[1].chromosome[i]);
-        }
-    }
-
-    return children;
-}
-
-uint8_t MutateBit(std::mt19937& generator, uint8_t bit)
-{
-    std::uniform_real_distribution<double> dist(0.0, 1.0);
-    double prob = dist(generator);
-    if (prob <= MUTATION_PROB) return !bit;
-    return bit;
-}
@@ -53,6 +53,19 @@ int main()
     auto encoded5p5 = EncodeFloat(5.5f);
     float decoded5p5 = DecodeFloat(encoded5p5);
 
+    // adjacent grid values differ in exactly one bit once Gray coded
+    std::cout << "\n";
+    for (float value : {51.1f, 51.2f, 51.3f})
+    {
+        std::array<Room, NUM_ROOMS> grayRooms = rooms;
+        grayRooms[0].length = value;
+        auto gray = EncodeChromosome(grayRooms, GeneEncoding::GRAY);
+        std::cout << value << "\t=>\t";
+        for (int k = 0; k < FLOAT_BITWIDTH; k++)
+            std::cout << static_cast<int>(gray[k]);
+        std::cout << "\t=>\t" << DecodeChromosome(gray, GeneEncoding::GRAY)[0].length << "\n";
+    }
+
     std::cout << std::setprecision(17);
     std::cout << "5.5f literal value: " << 5.5f << "\n";
     std::cout << "5.5f decoded value: " << decoded5p5 << "\n";
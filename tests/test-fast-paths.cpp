@@ -0,0 +1,801 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../Diversity.hpp"
+#include "../GeneticAlgorithm.hpp"
+#include "../PackedGenome.hpp"
+#include "../RoomPool.hpp"
+#include "../RoomSpec.hpp"
+#include "../Simd.hpp"
+#include "../SpecGenome.hpp"
+#include "../encoding.hpp"
+
+// Differential tests: every optimized path against the plain reference it replaces.
+// The reference side is always the original code: the float room model (Rooms.cpp), the one
+// byte per bit chromosome and its codecs (encoding.cpp) and RoomSetEvaluator.
+// Small domains (a 10-bit gene, a room's (length, width) grid) are swept exhaustively,
+// whole chromosomes are checked on random inputs from a fixed seed. Rooms exactly on a bound
+// the float model can round either way are skipped and counted (see IsBoundTie).
+// Usage: test-fast-paths [seed] [iterations]
+// Prints the first mismatches of every failing check and exits with 1 if any check failed.
+
+constexpr int GRID_SIZE = 1 << FLOAT_BITWIDTH;
+constexpr int MAX_REPORTED = 5;  // mismatches printed per check
+
+int failedChecks = 0;
+
+// Counts the mismatches of one check and prints the first few.
+class Check
+{
+public:
+    explicit Check(std::string name)
+        : name_(std::move(name))
+    {
+    }
+
+    ~Check()
+    {
+        std::cout << (mismatches_ == 0 ? "  ok    " : "  FAIL  ") << name_ << " (" << cases_
+                  << " cases";
+        if (ties_ > 0) std::cout << ", " << ties_ << " bound ties skipped";
+        if (mismatches_ > 0) std::cout << ", " << mismatches_ << " mismatches";
+        std::cout << ")\n";
+        if (mismatches_ > 0) failedChecks++;
+    }
+
+    // a case the float reference can't decide, see IsBoundTie
+    void Tie()
+    {
+        cases_++;
+        ties_++;
+    }
+
+    // returns passed, so callers can add detail to a failure
+    bool operator()(bool passed, const std::string& detail = "")
+    {
+        cases_++;
+        if (passed) return true;
+        if (++mismatches_ <= MAX_REPORTED) std::cout << "        " << detail << "\n";
+        return false;
+    }
+
+private:
+    std::string name_;
+    long cases_ = 0;
+    long ties_ = 0;
+    long mismatches_ = 0;
+};
+
+std::string RoomText(int index, int32_t length, int32_t width)
+{
+    return std::string(RoomTypeToString(ROOM_TYPES[index])) + " " + std::to_string(length) +
+           " x " + std::to_string(width) + " tenths";
+}
+
+// True when a room sits exactly on an area bound or a proportion range bound of its spec,
+// e.g. a 9.3 x 6.2 or a 9.6 x 12.5 kitchen. The float model accepts or rejects those depending
+// on how 9.3f / 6.2f or 9.6f * 12.5f round, while the fixed-point model compares exactly and
+// accepts them. These are the only sizes the two models disagree on, so the differential
+// checks skip them rather than enshrine either answer.
+bool IsBoundTie(int index, int32_t length, int32_t width)
+{
+    static const RoomSpecTable specs = DefaultRoomSpecs();
+    const RoomSpec& spec = specs[index];
+
+    // the bath's size is fixed, it has no area range to round across
+    const bool areaRange = spec.area.low < spec.area.high;
+    if (areaRange && (length * width == spec.area.low || length * width == spec.area.high))
+        return true;
+    if (spec.proportionKind != ProportionKind::RANGE) return false;
+    for (int32_t bound : {spec.proportion.low, spec.proportion.high})
+        if (10 * length == bound * width || 10 * width == bound * length) return true;
+    return false;
+}
+
+bool HasBoundTie(const PackedChromosome& binaryWords)
+{
+    for (int i = 0; i < NUM_ROOMS; i++)
+        if (IsBoundTie(i, PackedRoomLength(binaryWords[i]), PackedRoomWidth(binaryWords[i])))
+            return true;
+    return false;
+}
+
+bool CloseEnough(float reference, float fast)
+{
+    return std::abs(reference - fast) <= 1e-2f + 1e-5f * std::abs(reference);
+}
+
+// A random chromosome, half the time with valid rooms so the objective isn't always the
+// all-invalid constant.
+template <typename Rng>
+Chromosome RandomChromosome(Rng& generator)
+{
+    std::bernoulli_distribution coin(0.5);
+    if (coin(generator)) return EncodeChromosome(InitializeRoomSet(generator));
+
+    std::uniform_int_distribution<int> bit(0, 1);
+    Chromosome chromosome;
+    for (uint8_t& b : chromosome)
+        b = bit(generator);
+    return chromosome;
+}
+
+// ===== exhaustive sweeps =====
+
+void TestGeneCodecs()
+{
+    Check decode("EncodeFloat/DecodeFloat round trip, every gene value");
+    Check gray("RoomBinaryToGray/RoomGrayToBinary vs bitwise Gray code, every gene value");
+    for (int code = 0; code < GRID_SIZE; code++)
+    {
+        const float value = DecodeFloat(EncodeFloat(code / 10.0f));
+        decode(ToTenths(value) == code, "code " + std::to_string(code) + " decodes to " +
+                                            std::to_string(value));
+
+        // the reference Gray code, one bit at a time
+        uint64_t expectedGray = 0;
+        for (int bit = FLOAT_BITWIDTH - 1; bit >= 0; bit--)
+        {
+            const uint64_t b = (code >> bit) & 1;
+            const uint64_t above = bit + 1 < FLOAT_BITWIDTH ? (code >> (bit + 1)) & 1 : 0;
+            expectedGray |= (b ^ above) << bit;
+        }
+
+        for (int gene = 0; gene < 4; gene++)
+        {
+            const int shift = gene * FLOAT_BITWIDTH;
+            const uint64_t word = static_cast<uint64_t>(code) << shift;
+            gray(RoomBinaryToGray(word) == expectedGray << shift &&
+                     RoomGrayToBinary(expectedGray << shift) == word,
+                 "code " + std::to_string(code) + " in gene " + std::to_string(gene));
+        }
+    }
+}
+
+void TestFixedPointRooms()
+{
+    const RoomSpecTable specs = DefaultRoomSpecs();
+    Check validity("DoesRoomFitSpec (built-in table) vs DoesRoomFitConstraints, every room size");
+    Check objective("RoomSpecObjective (built-in table) vs RoomObjective, every room size");
+    for (int i = 0; i < NUM_ROOMS; i++)
+    {
+        for (int32_t length = 0; length < GRID_SIZE; length++)
+        {
+            for (int32_t width = 0; width < GRID_SIZE; width++)
+            {
+                const uint64_t word = PackRoomWord(length, width, 0, 0);
+                const Room room = DecodePackedRoom(word, i);
+
+                if (IsBoundTie(i, length, width))
+                {
+                    validity.Tie();
+                    objective.Tie();
+                    continue;
+                }
+
+                validity(DoesRoomFitConstraints(room) == DoesRoomFitSpec(specs[i], length, width),
+                         RoomText(i, length, width));
+                const float specObjective = RoomSpecObjective(specs[i], length, width) / 100.0f;
+                objective(CloseEnough(RoomObjective(room, i), specObjective),
+                          RoomText(i, length, width));
+            }
+        }
+    }
+}
+
+void TestRoomSpecs()
+{
+    const RoomSpecTable specs = DefaultRoomSpecs();
+
+    // the pools are built from DoesRoomFitSpec, so hold them against the float model instead
+    const RoomPools pools(specs);
+    Check pool("RoomPools vs every valid size of the float model, ties aside");
+    for (int i = 0; i < NUM_ROOMS; i++)
+    {
+        std::set<uint32_t> expected;
+        for (int32_t length = 0; length < GRID_SIZE; length++)
+            for (int32_t width = 0; width < GRID_SIZE; width++)
+                if (!IsBoundTie(i, length, width) &&
+                    DoesRoomFitConstraints(DecodePackedRoom(PackRoomWord(length, width, 0, 0), i)))
+                    expected.insert(RoomPools::PoolEntry(length, width));
+
+        const std::span<const uint32_t> sizes = pools.Sizes(i);
+        std::set<uint32_t> actual;
+        for (uint32_t entry : sizes)
+            if (!IsBoundTie(i, RoomPools::EntryLength(entry), RoomPools::EntryWidth(entry)))
+                actual.insert(entry);
+        const bool unique = std::set<uint32_t>(sizes.begin(), sizes.end()).size() == sizes.size();
+        pool(unique && actual == expected,
+             std::string(RoomTypeToString(ROOM_TYPES[i])) + ": " + std::to_string(sizes.size()) +
+                 " pooled, " + std::to_string(expected.size()) + " valid");
+    }
+}
+
+// every kernel table this CPU can run, the scalar one included
+std::vector<SimdLevel> SupportedSimdLevels()
+{
+    std::vector<SimdLevel> levels;
+    for (SimdLevel level : {SimdLevel::SCALAR, SimdLevel::AVX2, SimdLevel::AVX512})
+        if (IsSimdLevelSupported(level)) levels.push_back(level);
+    return levels;
+}
+
+void TestSimdRoomKernels()
+{
+    const RoomSpecTable specs = DefaultRoomSpecs();
+    for (SimdLevel level : SupportedSimdLevels())
+    {
+        const SimdKernels& kernels = KernelsFor(level);
+        const std::string name(SimdLevelToString(level));
+
+        Check gray(name + " grayToBinary vs RoomGrayToBinary, every gene value");
+        std::vector<uint64_t> words(GRID_SIZE);
+        for (uint64_t value = 0; value < GRID_SIZE; value++)
+            words[value] = PackRoomWord(value, value, value, value);
+        std::vector<uint64_t> expected = words;
+        for (uint64_t& word : expected)
+            word = RoomGrayToBinary(word);
+        kernels.grayToBinary(words.data(), words.size());
+        for (int value = 0; value < GRID_SIZE; value++)
+            gray(words[value] == expected[value], "gene value " + std::to_string(value));
+
+        // a row of widths per length, the way RoomPools calls it
+        Check evaluate(name + " evaluateRooms vs RoomSpecObjective and DoesRoomFitSpec, " +
+                       "every room size");
+        std::vector<int32_t> objectives(GRID_SIZE);
+        std::vector<uint8_t> fits(GRID_SIZE);
+        for (int i = 0; i < specs.size(); i++)
+        {
+            for (int32_t length = 0; length < GRID_SIZE; length++)
+            {
+                for (int32_t width = 0; width < GRID_SIZE; width++)
+                    words[width] = PackRoomWord(length, width, width, length);
+                kernels.evaluateRooms(specs[i], words.data(), GRID_SIZE, objectives.data(),
+                                      fits.data());
+                for (int32_t width = 0; width < GRID_SIZE; width++)
+                    evaluate(objectives[width] == RoomSpecObjective(specs[i], length, width) &&
+                                 fits[width] == DoesRoomFitSpec(specs[i], length, width),
+                             RoomText(i, length, width));
+            }
+        }
+    }
+}
+
+// ===== randomized properties =====
+
+void TestPacking(std::mt19937& generator, int iterations)
+{
+    Check pack("PackChromosome/UnpackChromosome round trip");
+    Check decode("DecodePackedChromosome vs DecodeChromosome");
+    for (int n = 0; n < iterations; n++)
+    {
+        const Chromosome chromosome = RandomChromosome(generator);
+        const PackedChromosome packed = PackChromosome(chromosome);
+        pack(UnpackChromosome(packed) == chromosome, "iteration " + std::to_string(n));
+
+        const RoomSet expected = DecodeChromosome(chromosome);
+        const RoomSet actual = DecodePackedChromosome(packed);
+        bool same = true;
+        for (int i = 0; i < NUM_ROOMS; i++)
+            same = same && expected[i].length == actual[i].length &&
+                   expected[i].width == actual[i].width && expected[i].x == actual[i].x &&
+                   expected[i].y == actual[i].y && expected[i].type == actual[i].type;
+        decode(same, "iteration " + std::to_string(n));
+    }
+}
+
+void TestOperators(std::mt19937& generator, int iterations)
+{
+    std::uniform_int_distribution<int> bitDist(0, CHROMOSOME_BITWIDTH - 1);
+    std::uniform_int_distribution<int> cutDist(1, CHROMOSOME_BITWIDTH - 1);
+
+    Check flip("packed FlipBit vs flipping the unpacked bit");
+    Check cut("XorSuffix mask + Blend vs single point splice");
+    Check uniform("UniformMask + Blend vs per-bit choice");
+    Check flipAll("PackedBitFlipMutation at probability 1 flips every bit");
+    for (int n = 0; n < iterations; n++)
+    {
+        const Chromosome a = RandomChromosome(generator);
+        const Chromosome b = RandomChromosome(generator);
+
+        const int i = bitDist(generator);
+        PackedChromosome flipped = PackChromosome(a);
+        FlipBit(flipped, i);
+        Chromosome expected = a;
+        expected[i] ^= 1;
+        flip(UnpackChromosome(flipped) == expected, "bit " + std::to_string(i));
+
+        // same cut as SinglePointCrossover: bits from the index on come from the other parent
+        const int index = cutDist(generator);
+        std::array<uint64_t, NUM_ROOMS> mask{};
+        XorSuffix(mask, index);
+        PackedChromosome child;
+        Blend(mask, PackChromosome(a), PackChromosome(b), child);
+        for (int k = 0; k < CHROMOSOME_BITWIDTH; k++)
+            expected[k] = k < index ? a[k] : b[k];
+        cut(UnpackChromosome(child) == expected, "cut at " + std::to_string(index));
+
+        mask.fill(0);
+        UniformMask{}(generator, std::span<uint64_t>(mask));
+        Blend(mask, PackChromosome(a), PackChromosome(b), child);
+        const Chromosome maskBits = UnpackChromosome(mask);
+        for (int k = 0; k < CHROMOSOME_BITWIDTH; k++)
+            expected[k] = maskBits[k] ? b[k] : a[k];
+        uniform(UnpackChromosome(child) == expected, "iteration " + std::to_string(n));
+
+        PackedChromosome all = PackChromosome(a);
+        PackedBitFlipMutation{1.0}(generator, all);
+        for (int k = 0; k < CHROMOSOME_BITWIDTH; k++)
+            expected[k] = !a[k];
+        flipAll(UnpackChromosome(all) == expected, "iteration " + std::to_string(n));
+    }
+}
+
+template <GeneEncoding Encoding>
+void TestEvaluators(std::mt19937& generator, int iterations)
+{
+    const std::string encoding = Encoding == GeneEncoding::GRAY ? " (gray)" : " (binary)";
+    const RoomSpecTable specs = DefaultRoomSpecs();
+    const RoomSetEvaluator<Encoding> reference;
+    const SpecEvaluator<Encoding> specEvaluator{&specs, GetSpecCostRange(specs)};
+
+    Check spec("SpecEvaluator after crossover and mutation vs RoomSetEvaluator" + encoding);
+
+    auto compare = [](Check& check, const EvaluationResult& expected,
+                      const EvaluationResult& actual, const std::string& detail) {
+        check(CloseEnough(expected.objective, actual.objective) &&
+                  CloseEnough(expected.fitness, actual.fitness),
+              detail + ": objective " + std::to_string(expected.objective) + " vs " +
+                  std::to_string(actual.objective) + ", fitness " +
+                  std::to_string(expected.fitness) + " vs " + std::to_string(actual.fitness));
+    };
+
+    // a lineage bred with the engine's own operators, so its room caches go stale the way
+    // they do in a run
+    SpecChromosome specParents[2];
+    for (int p = 0; p < 2; p++)
+    {
+        const PackedChromosome words = PackChromosome(RandomChromosome(generator));
+        for (uint64_t word : words)
+            specParents[p].push_back(SpecRoomGene{word, 0, true});
+        specEvaluator(specParents[p]);
+    }
+
+    const MaskCrossover<BitNPointMask> crossover{1.0, {2}};
+    const PackedBitFlipMutation mutation{0.01};
+    for (int n = 0; n < iterations; n++)
+    {
+        const std::string detail = "iteration " + std::to_string(n);
+
+        SpecChromosome specChildren[2];
+        crossover(generator, mutation, specParents[0], specParents[1], specChildren[0],
+                  specChildren[1]);
+
+        for (int c = 0; c < 2; c++)
+        {
+            PackedChromosome words;
+            PackedChromosome binaryWords;
+            for (int w = 0; w < NUM_ROOMS; w++)
+            {
+                words[w] = specChildren[c][w].word;
+                binaryWords[w] = SpecGenome<Encoding>::ToBinaryWord(words[w]);
+            }
+            if (HasBoundTie(binaryWords))
+                spec.Tie();
+            else
+                compare(spec, reference(UnpackChromosome(words)), specEvaluator(specChildren[c]),
+                        detail);
+        }
+
+        // the child replaces a random parent, so the lineage keeps evolving
+        std::bernoulli_distribution coin(0.5);
+        specParents[coin(generator)] = specChildren[1];
+    }
+}
+
+void TestDiversity(std::mt19937& generator, int iterations)
+{
+    Check diversity("MeasureDiversity vs pairwise brute force");
+    std::uniform_int_distribution<int> sizeDist(2, 600);  // past a byte counter flush
+    std::uniform_int_distribution<int> roomsDist(1, 9);
+    for (int n = 0; n < std::max(1, iterations / 50); n++)
+    {
+        const int individuals = sizeDist(generator);
+        const int rooms = roomsDist(generator);
+
+        // few distinct words per room, so duplicates and shared alleles are common
+        std::uniform_int_distribution<uint64_t> wordDist(0, 3);
+        std::uniform_int_distribution<uint64_t> fullDist(0, ROOM_WORD_MASK);
+        std::vector<uint64_t> palette(4 * rooms);
+        for (uint64_t& word : palette)
+            word = fullDist(generator);
+        std::vector<uint64_t> rows(individuals * rooms);
+        for (int i = 0; i < individuals; i++)
+            for (int r = 0; r < rooms; r++)
+                rows[i * rooms + r] = palette[4 * r + wordDist(generator)];
+
+        const DiversityStatistics measured = MeasureDiversity(rows, individuals);
+
+        double pairDistance = 0.0;
+        std::set<std::vector<uint64_t>> unique;
+        for (int i = 0; i < individuals; i++)
+        {
+            std::vector<uint64_t> effective(rooms);
+            for (int r = 0; r < rooms; r++)
+                effective[r] = rows[i * rooms + r] & EFFECTIVE_ROOM_MASK;
+            unique.insert(effective);
+
+            for (int j = i + 1; j < individuals; j++)
+                for (int r = 0; r < rooms; r++)
+                    pairDistance += std::popcount(rows[i * rooms + r] ^ rows[j * rooms + r]);
+        }
+        const double meanHamming = pairDistance / (individuals * (individuals - 1) / 2.0);
+
+        bool allelesMatch = measured.alleleFrequencies.size() == rooms * ROOM_BITWIDTH;
+        for (int bit = 0; allelesMatch && bit < rooms * ROOM_BITWIDTH; bit++)
+        {
+            const int r = bit / ROOM_BITWIDTH;
+            const int shift = ROOM_BITWIDTH - 1 - bit % ROOM_BITWIDTH;
+            int set = 0;
+            for (int i = 0; i < individuals; i++)
+                set += (rows[i * rooms + r] >> shift) & 1;
+            allelesMatch = std::abs(measured.alleleFrequencies[bit] -
+                                    static_cast<float>(set) / individuals) < 1e-6f;
+        }
+
+        diversity(std::abs(measured.meanHamming - meanHamming) < 1e-9 * (1.0 + meanHamming) &&
+                      measured.uniqueGenomes == unique.size() && allelesMatch,
+                  std::to_string(individuals) + " x " + std::to_string(rooms) +
+                      " rooms: mean Hamming " + std::to_string(measured.meanHamming) + " vs " +
+                      std::to_string(meanHamming) + ", unique " +
+                      std::to_string(measured.uniqueGenomes) + " vs " +
+                      std::to_string(unique.size()));
+    }
+}
+
+void TestSimdKernels(std::mt19937& generator, int iterations)
+{
+    // populations of 1 to 600 individuals: every vector tail length, and past a byte flush
+    std::uniform_int_distribution<int> sizeDist(1, 600);
+    std::uniform_int_distribution<int> roomsDist(1, 9);
+    std::uniform_int_distribution<uint64_t> wordDist(0, ROOM_WORD_MASK);
+    std::uniform_real_distribution<float> valueDist(-50.0f, 200.0f);
+    const SimdKernels& scalar = KernelsFor(SimdLevel::SCALAR);
+
+    for (SimdLevel level : SupportedSimdLevels())
+    {
+        const SimdKernels& kernels = KernelsFor(level);
+        const std::string name(SimdLevelToString(level));
+        Check alleles(name + " countAlleles vs counting every bit");
+        Check reduce(name + " reduce vs a sequential pass, bit-identical to scalar");
+
+        for (int n = 0; n < std::max(1, iterations / 50); n++)
+        {
+            const int individuals = sizeDist(generator);
+            const int rooms = roomsDist(generator);
+            std::vector<uint64_t> rows(individuals * rooms);
+            for (uint64_t& word : rows)
+                word = wordDist(generator);
+
+            std::vector<int> counts(rooms * 64, 0);
+            kernels.countAlleles(rows.data(), individuals, rooms, counts.data());
+            std::vector<int> expected(rooms * 64, 0);
+            for (int i = 0; i < individuals; i++)
+                for (int r = 0; r < rooms; r++)
+                    for (int bit = 0; bit < 64; bit++)
+                        expected[r * 64 + bit] += (rows[i * rooms + r] >> bit) & 1;
+            alleles(counts == expected, std::to_string(individuals) + " individuals, " +
+                                            std::to_string(rooms) + " rooms");
+
+            // small integers now and then, so the minimum and maximum are often tied
+            std::vector<float> values(individuals);
+            for (float& value : values)
+                value = n % 2 == 0 ? valueDist(generator) : std::floor(valueDist(generator) / 50);
+
+            const SimdReduction reduction = kernels.reduce(values.data(), values.size());
+            const SimdReduction reference = scalar.reduce(values.data(), values.size());
+            double sum = 0.0;
+            for (float value : values)
+                sum += value;
+            const auto fittest = std::max_element(values.begin(), values.end());
+            reduce(reduction.min == *std::min_element(values.begin(), values.end()) &&
+                       reduction.max == *fittest &&
+                       reduction.maxIndex == fittest - values.begin() &&
+                       std::abs(reduction.sum - sum) <= 1e-9 * (1.0 + std::abs(sum)) &&
+                       reduction.sum == reference.sum,
+                   std::to_string(individuals) + " values: sum " + std::to_string(reduction.sum) +
+                       " vs " + std::to_string(sum) + ", max index " +
+                       std::to_string(reduction.maxIndex) + " vs " +
+                       std::to_string(fittest - values.begin()));
+        }
+    }
+}
+
+void TestInitialization(std::mt19937& generator)
+{
+    const RoomSpecTable specs = DefaultRoomSpecs();
+    const RoomPools pools(specs);
+    using Member = BasicIndividual<SpecChromosome>;
+
+    Check valid("pool and stratified initialization only produce valid rooms");
+    Check stratified("stratified initialization covers each pool exactly once");
+    for (InitSampling sampling : {InitSampling::POOL, InitSampling::STRATIFIED})
+    {
+        const SpecGenome<GeneEncoding::GRAY> genome{&specs, &pools, sampling};
+        for (int i = 0; i < NUM_ROOMS; i++)
+        {
+            // one individual per pool entry, so a Latin hypercube hits every entry once
+            const int size = static_cast<int>(pools.Sizes(i).size());
+            std::vector<Member> population(size);
+            genome.InitializePopulation(generator, std::span<Member>(population));
+
+            std::vector<int> hits(size);
+            for (const Member& x : population)
+            {
+                const uint64_t word = RoomGrayToBinary(x.chromosome[i].word);
+                const int32_t length = PackedRoomLength(word);
+                const int32_t width = PackedRoomWidth(word);
+                if (IsBoundTie(i, length, width))
+                    valid.Tie();
+                else
+                    valid(DoesRoomFitConstraints(DecodePackedRoom(word, i)),
+                          RoomText(i, length, width));
+
+                const auto sizes = pools.Sizes(i);
+                const auto entry = std::find(sizes.begin(), sizes.end(),
+                                             RoomPools::PoolEntry(length, width));
+                if (entry != sizes.end()) hits[entry - sizes.begin()]++;
+            }
+
+            if (sampling == InitSampling::STRATIFIED)
+                stratified(std::all_of(hits.begin(), hits.end(), [](int h) { return h == 1; }),
+                           std::string(RoomTypeToString(ROOM_TYPES[i])));
+        }
+    }
+}
+
+// The room report lines against the stream manipulators they replaced, on every room word
+// shape: random codes, random broken constraints, and values wide enough to overflow a cell.
+void TestRoomReports(std::mt19937& generator, int iterations)
+{
+    Check cells("WriteRoomCells vs std::setw / std::setprecision formatting");
+    Check bits("WriteRoomBits vs PrintChromosome's bit by bit output");
+    std::uniform_int_distribution<int> codeDist(0, static_cast<int>(GENE_MASK));
+    std::uniform_int_distribution<ViolationMask> maskDist(0, ALL_VIOLATIONS);
+    for (int n = 0; n < iterations; n++)
+    {
+        const uint64_t word = PackRoomWord(codeDist(generator), codeDist(generator),
+                                           codeDist(generator), codeDist(generator));
+        const ViolationMask violations = maskDist(generator);
+        const float length = static_cast<float>(PackedRoomLength(word) * 0.1);
+        const float width = static_cast<float>(PackedRoomWidth(word) * 0.1);
+        const float x = static_cast<float>(((word >> FLOAT_BITWIDTH) & GENE_MASK) * 0.1);
+        const float y = static_cast<float>((word & GENE_MASK) * 0.1);
+
+        std::ostringstream reference;
+        const auto cell = [&](float value, int cellWidth, bool violated) {
+            const char marker = violated ? '~' : ' ';
+            reference << marker << std::setfill(marker) << std::fixed << std::setw(cellWidth)
+                      << std::setprecision(6) << value << marker << '|';
+        };
+        const bool badProportion = violations & PROPORTION_VIOLATION;
+        cell(length, 9, violations & LENGTH_VIOLATION);
+        cell(width, 10, violations & WIDTH_VIOLATION);
+        cell(x, 10, false);
+        cell(y, 10, false);
+        cell(length * width, 12, violations & AREA_VIOLATION);
+        cell(width > 0.0f ? length / width : 0.0f, 10, badProportion);
+        cell(length > 0.0f ? width / length : 0.0f, 10, badProportion);
+
+        std::array<char, ROOM_REPORT_LINE> line;
+        const std::string written(line.data(),
+                                  WriteRoomCells(line.data(), violations, length, width, x, y));
+        cells(written == reference.str(), "\"" + written + "\" vs \"" + reference.str() + "\"");
+
+        std::string expected;
+        for (int j = 0; j < 4; j++)
+        {
+            for (int k = 0; k < FLOAT_BITWIDTH; k++)
+                expected += static_cast<char>(
+                    '0' + ((word >> (ROOM_BITWIDTH - 1 - j * FLOAT_BITWIDTH - k)) & 1));
+            expected += " | ";
+        }
+        bits(std::string(line.data(), WriteRoomBits(line.data(), word)) == expected, expected);
+    }
+}
+
+// The change-only log of each generation's best against the plain per-generation vector it
+// replaced, on runs of bests that mostly repeat or flip a few bits.
+void TestFittestLog(std::mt19937& generator, int iterations)
+{
+    Check lookups("FittestLog::At and ForEachGeneration vs a FittestIndividual per generation");
+    Check changes("FittestLog::ForEachChange and FittestGeneration vs the same");
+    std::uniform_int_distribution<int> roomsDist(1, 12);
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    for (int run = 0; run < iterations / 100; run++)
+    {
+        const int rooms = roomsDist(generator);
+        const int generations = 1 + run % 300;
+        std::uniform_int_distribution<int> roomDist(0, rooms - 1);
+        std::uniform_int_distribution<int> bitDist(0, ROOM_BITWIDTH - 1);
+
+        std::vector<FittestIndividual> reference(generations + 1);
+        FittestLog log;
+        FittestIndividual best{std::vector<uint64_t>(rooms), 0.0f, 0.0f};
+        for (int gen = 0; gen <= generations; gen++)
+        {
+            const double roll = dist(generator);
+            if (gen == 0 || roll < 0.1)
+                for (uint64_t& word : best.rooms)
+                    word = (uint64_t{generator()} << 32 | generator()) & ROOM_WORD_MASK;
+            else if (roll < 0.4)
+                best.rooms[roomDist(generator)] ^= uint64_t{1} << bitDist(generator);
+            if (roll < 0.45) best.fitness = static_cast<float>(roomDist(generator));
+            best.objective = best.fitness * 3.0f;
+
+            reference[gen] = best;
+            log.Record(gen, best.rooms, best.objective, best.fitness);
+        }
+
+        const auto same = [](const FittestIndividual& a, const FittestIndividual& b) {
+            return a.rooms == b.rooms && a.objective == b.objective && a.fitness == b.fitness;
+        };
+        const std::string detail =
+            std::to_string(rooms) + " rooms, " + std::to_string(generations) + " generations";
+        for (int gen = 0; gen <= generations; gen++)
+            lookups(same(log.At(gen), reference[gen]),
+                    detail + ", At(" + std::to_string(gen) + ")");
+        int next = 0;
+        log.ForEachGeneration(generations, [&](int gen, const FittestIndividual& individual) {
+            lookups(gen == next++ && same(individual, reference[gen]),
+                    detail + ", ForEachGeneration at " + std::to_string(gen));
+        });
+        lookups(next == generations + 1, detail + ", ForEachGeneration stopped early");
+
+        std::vector<int> changed;
+        for (int gen = 0; gen <= generations; gen++)
+            if (gen == 0 || !same(reference[gen], reference[gen - 1])) changed.push_back(gen);
+        std::vector<int> logged;
+        log.ForEachChange(generations, [&](int gen, const FittestIndividual& individual) {
+            logged.push_back(gen);
+            changes(same(individual, reference[gen]),
+                    detail + ", ForEachChange at " + std::to_string(gen));
+        });
+        changes(logged == changed && log.ChangeCount() == changed.size(),
+                detail + ", " + std::to_string(logged.size()) + " changes logged, " +
+                    std::to_string(changed.size()) + " expected");
+
+        const int fittest = static_cast<int>(
+            std::max_element(reference.begin(), reference.end(),
+                             [](const FittestIndividual& a, const FittestIndividual& b) {
+                                 return a.fitness < b.fitness;
+                             }) -
+            reference.begin());
+        const int logFittest = log.FittestGeneration(generations);
+        changes(logFittest == fittest, detail + ", FittestGeneration " +
+                                           std::to_string(logFittest) + " vs " +
+                                           std::to_string(fittest));
+    }
+}
+
+// The lock-step engine against the trial by trial one: its batched evaluation against the
+// per-chromosome evaluator, then whole runs, which must match generation for generation.
+void TestLockStep(std::mt19937& generator, int iterations)
+{
+    const RoomSpecTable specs = DefaultRoomSpecs();
+    const RoomPools pools(specs);
+    const SpecEvaluator<GeneEncoding::GRAY> evaluator{&specs, GetSpecCostRange(specs)};
+
+    Check batch("SpecEvaluator::EvaluateBatch vs per-chromosome evaluation");
+    std::bernoulli_distribution dirty(0.3);
+    std::uniform_int_distribution<uint64_t> wordDist(0, ROOM_WORD_MASK);
+    std::vector<SpecChromosome> batched(iterations / 100 + 1);
+    std::vector<SpecChromosome> single;
+    std::vector<SpecChromosome*> pointers;
+    for (SpecChromosome& chromosome : batched)
+    {
+        // a clean cache from an earlier evaluation, with some rooms changed since
+        for (uint64_t word : PackChromosome(RandomChromosome(generator)))
+            chromosome.push_back(SpecRoomGene{word, 0, true});
+        evaluator(chromosome);
+        for (SpecRoomGene& room : chromosome)
+        {
+            if (!dirty(generator)) continue;
+            room.word = wordDist(generator);
+            room.dirty = true;
+        }
+        single.push_back(chromosome);
+        pointers.push_back(&chromosome);
+    }
+    std::vector<EvaluationResult> results(batched.size());
+    evaluator.EvaluateBatch(std::span<SpecChromosome* const>(pointers),
+                            std::span<EvaluationResult>(results));
+    for (int c = 0; c < batched.size(); c++)
+    {
+        const EvaluationResult expected = evaluator(single[c]);
+        batch(results[c].objective == expected.objective &&
+                  results[c].fitness == expected.fitness,
+              "chromosome " + std::to_string(c) + ": objective " +
+                  std::to_string(results[c].objective) + " vs " +
+                  std::to_string(expected.objective));
+    }
+
+    // with adaptive rates the trials also share the operator policies they set their rates on
+    Check runs("RunLockStep vs Run, trial by trial, with fixed and adaptive rates");
+    for (bool adaptive : {false, true})
+    {
+        GAConfig config;
+        config.generations = 60;
+        config.elitismCount = 3;  // odd, so the last pair drops a child
+        config.stallGenerations = 10;  // the trials stop at different generations
+        config.adaptiveRates = adaptive;
+        const SpecGenome<GeneEncoding::GRAY> genome{&specs, &pools, InitSampling::POOL};
+        SpecGeneticAlgorithm<TournamentSelection, BitNPointMask, GeneEncoding::GRAY> ga(
+            config, TournamentSelection{3}, MaskCrossover<BitNPointMask>{CROSSOVER_PROB, {2}},
+            PackedBitFlipMutation{0.01}, evaluator, genome);
+
+        std::vector<std::random_device::result_type> seeds(6);
+        for (auto& seed : seeds)
+            seed = generator();
+        const std::vector<Statistics> lockStep =
+            ga.RunLockStep(std::span<const std::random_device::result_type>(seeds));
+        for (int t = 0; t < seeds.size(); t++)
+        {
+            const Statistics alone = ga.Run(seeds[t]);
+            bool same = lockStep[t].lastGeneration == alone.lastGeneration &&
+                        lockStep[t].stopReason == alone.stopReason;
+            for (int gen = 0; same && gen <= alone.lastGeneration; gen++)
+                same = lockStep[t].maxFitnesses[gen] == alone.maxFitnesses[gen] &&
+                       lockStep[t].avgFitnesses[gen] == alone.avgFitnesses[gen] &&
+                       lockStep[t].evaluations[gen] == alone.evaluations[gen] &&
+                       lockStep[t].mutationRates[gen] == alone.mutationRates[gen] &&
+                       lockStep[t].crossoverRates[gen] == alone.crossoverRates[gen] &&
+                       lockStep[t].fittest.At(gen).rooms == alone.fittest.At(gen).rooms;
+            runs(same, std::string(adaptive ? "adaptive" : "fixed") + " trial " +
+                           std::to_string(t) + " with seed " + std::to_string(seeds[t]));
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    unsigned int seed = 776;
+    int iterations = 20000;
+    if (argc > 1) seed = std::stoul(argv[1]);
+    if (argc > 2) iterations = std::stoi(argv[2]);
+    std::mt19937 generator(seed);
+
+    std::cout << "Exhaustive sweeps\n";
+    TestGeneCodecs();
+    TestFixedPointRooms();
+    TestRoomSpecs();
+    TestSimdRoomKernels();
+
+    std::cout << "Randomized, seed " << seed << ", " << iterations << " iterations\n";
+    TestPacking(generator, iterations);
+    TestOperators(generator, iterations);
+    TestEvaluators<GeneEncoding::BINARY>(generator, iterations);
+    TestEvaluators<GeneEncoding::GRAY>(generator, iterations);
+    TestDiversity(generator, iterations);
+    TestSimdKernels(generator, iterations);
+    TestInitialization(generator);
+    TestRoomReports(generator, iterations);
+    TestFittestLog(generator, iterations);
+    TestLockStep(generator, iterations);
+
+    std::cout << (failedChecks == 0 ? "All checks passed\n"
+                                    : std::to_string(failedChecks) + " check(s) failed\n");
+    return failedChecks == 0 ? 0 : 1;
+}
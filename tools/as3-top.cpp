@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+#include "../Telemetry.hpp"
+
+// Live progress of a running as3, read from its telemetry ring (see Telemetry.hpp).
+// Usage: as3-top [PID] [--once]
+// Without a PID it follows the newest as3 that is still running.
+// --once prints a single snapshot instead of refreshing until the run ends.
+
+constexpr auto REFRESH_INTERVAL = std::chrono::milliseconds(500);
+constexpr auto STALE_AFTER = std::chrono::seconds(2);  // a trial that went quiet has ended
+constexpr int MAX_ROWS = 20;
+
+// the newest segment in /dev/shm whose owner is still alive, or 0
+long FindRunningPid()
+{
+    constexpr std::string_view prefix = TelemetryRing::SEGMENT_PREFIX;
+
+    long newestPid = 0;
+    std::filesystem::file_time_type newestTime{};
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator("/dev/shm", error))
+    {
+        const std::string name = entry.path().filename().string();
+        if (name.rfind(prefix, 0) != 0) continue;
+
+        const long pid = std::atol(name.c_str() + prefix.size());
+        const auto time = entry.last_write_time(error);
+        if (pid > 0 && TelemetryRing::IsProcessRunning(pid) &&
+            (newestPid == 0 || time > newestTime))
+        {
+            newestPid = pid;
+            newestTime = time;
+        }
+    }
+    return newestPid;
+}
+
+struct TrialView
+{
+    TelemetrySample sample;
+    std::chrono::steady_clock::time_point updated;
+};
+
+int main(int argc, char** argv)
+{
+    long pid = 0;
+    bool once = false;
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--once")
+            once = true;
+        else if (pid == 0 && std::atol(arg.c_str()) > 0)
+            pid = std::atol(arg.c_str());
+        else
+        {
+            std::cerr << "Usage: as3-top [PID] [--once]\n";
+            return 2;
+        }
+    }
+
+    if (pid == 0) pid = FindRunningPid();
+    TelemetryRing ring;
+    if (pid == 0 || !ring.Open(TelemetryRing::SegmentName(pid)))
+    {
+        std::cerr << "No running as3 found" << (pid != 0 ? " with pid " + std::to_string(pid) : "")
+                  << " (was it started with --telemetry off?)\n";
+        return 1;
+    }
+
+    // start with whatever history the ring still holds
+    const uint64_t head = ring.Head();
+    uint64_t next = head > TelemetryRing::CAPACITY ? head - TelemetryRing::CAPACITY : 0;
+    uint64_t dropped = 0;
+    std::map<std::pair<uint32_t, uint32_t>, TrialView> trials;  // by (job, trial)
+
+    while (true)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        const bool finished = ring.Done() || !TelemetryRing::IsProcessRunning(pid);
+
+        for (uint64_t end = ring.Head(); next < end; next++)
+        {
+            TelemetrySample sample;
+            if (ring.Read(next, sample))
+                trials[{sample.job, sample.trial}] = TrialView{sample, now};
+            else if (next + TelemetryRing::CAPACITY > ring.Head())
+                break;  // still being written, pick it up on the next refresh
+            else
+                dropped++;  // overwritten before we got to it
+        }
+
+        std::erase_if(trials, [&](const auto& entry) {
+            const TelemetrySample& sample = entry.second.sample;
+            return sample.generation >= sample.generations ||
+                   now - entry.second.updated > STALE_AFTER;
+        });
+
+        double evaluationsPerSecond = 0.0;
+        for (const auto& [key, view] : trials)
+            evaluationsPerSecond += view.sample.evaluationsPerSecond;
+
+        if (!once) std::cout << "\x1b[H\x1b[2J";  // home and clear
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "as3 (pid " << pid << "): " << ring.FinishedTrials() << "/"
+                  << ring.TotalTrials() << " trials finished, " << trials.size() << " running, "
+                  << std::setprecision(0) << evaluationsPerSecond << " evaluations/s";
+        if (dropped > 0) std::cout << ", " << dropped << " records missed";
+        std::cout << "\n\n";
+
+        std::cout << "   Job  Trial    Generation   BestFit    AvgFit      Evals/s\n";
+        int rows = 0;
+        for (const auto& [key, view] : trials)
+        {
+            if (++rows > MAX_ROWS)
+            {
+                std::cout << "   ... " << trials.size() - MAX_ROWS << " more\n";
+                break;
+            }
+
+            const TelemetrySample& sample = view.sample;
+            std::cout << std::setw(6) << sample.job << std::setw(7) << sample.trial
+                      << std::setw(8) << sample.generation << "/" << std::left << std::setw(5)
+                      << sample.generations << std::right << std::setprecision(2)
+                      << std::setw(10) << sample.bestFitness << std::setw(10)
+                      << sample.avgFitness << std::setprecision(0) << std::setw(13)
+                      << sample.evaluationsPerSecond << "\n";
+        }
+        std::cout << std::flush;
+
+        if (once) return 0;
+        if (finished)
+        {
+            std::cout << "\nas3 has finished\n";
+            return 0;
+        }
+        std::this_thread::sleep_for(REFRESH_INTERVAL);
+    }
+}
@@ -0,0 +1,26 @@
+#include <iostream>
+
+#include "../Trajectory.hpp"
+
+// Checks that two builds did the same work and compares how long they took.
+// Record the baseline with `as3 --seed S ...`, keep its data/trajectory.txt, then run the
+// candidate build with `as3 --replay baseline-trajectory.txt` and compare the two files.
+// Usage: as3-compare BASELINE CANDIDATE
+// Exits with 0 if every trial followed the same trajectory, 1 if not, 2 on bad input.
+
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        std::cerr << "Usage: as3-compare BASELINE CANDIDATE\n";
+        return 2;
+    }
+
+    Trajectory baseline;
+    Trajectory candidate;
+    if (!ReadTrajectory(argv[1], baseline, std::cerr) ||
+        !ReadTrajectory(argv[2], candidate, std::cerr))
+        return 2;
+
+    return CompareTrajectories(baseline, candidate, std::cout) ? 0 : 1;
+}